@@ -0,0 +1,70 @@
+#include "synthetic_log.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace jsonl::bench {
+
+namespace {
+
+// splitmix64: small, seedable, good enough for field distributions.
+std::uint64_t next(std::uint64_t& state) noexcept {
+  std::uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  return z ^ (z >> 31);
+}
+
+const char* const kEndpoints[] = {
+    "/api/checkout", "/api/cart",   "/api/search", "/api/login",
+    "/api/profile",  "/api/browse", "/healthz",    "/api/recommend",
+};
+constexpr int kStatuses[] = {200, 200, 200, 200, 200, 200, 301, 404, 500, 503};
+
+}  // namespace
+
+std::uint64_t write_synthetic_log(const std::string& path,
+                                  const SyntheticLogOptions& options) {
+  std::FILE* f = std::fopen(path.c_str(), "wb");
+  if (f == nullptr) {
+    throw std::runtime_error("synthetic log: cannot open " + path);
+  }
+
+  std::uint64_t state = options.seed;
+  std::uint64_t total = 0;
+  std::string pad;
+  char head[512];
+
+  for (std::uint64_t i = 0; i < options.record_count; ++i) {
+    const std::uint64_t r = next(state);
+    // Monotonic-ish epoch-millis timestamps with jitter, like production.
+    const std::uint64_t ts = 1'700'000'000'000ull + i * 13 + (r & 7);
+    const char* endpoint = kEndpoints[r % (sizeof(kEndpoints) / sizeof(*kEndpoints))];
+    const int status = kStatuses[(r >> 8) % (sizeof(kStatuses) / sizeof(*kStatuses))];
+    const std::uint64_t latency = 1 + ((r >> 16) % 900);
+    const std::uint64_t user = (r >> 32) % 1'000'000;
+
+    int n = std::snprintf(
+        head, sizeof(head),
+        "{\"timestamp\":%" PRIu64 ",\"endpoint\":\"%s\",\"latency_ms\":%" PRIu64
+        ",\"status\":%d,\"user_id\":\"u%" PRIu64 "\",\"pad\":\"",
+        ts, endpoint, latency, status, user);
+
+    std::size_t pad_len = options.record_bytes > static_cast<std::size_t>(n) + 3
+                              ? options.record_bytes - n - 3
+                              : 0;
+    pad.assign(pad_len, 'x');
+
+    std::fwrite(head, 1, n, f);
+    std::fwrite(pad.data(), 1, pad.size(), f);
+    std::fwrite("\"}\n", 1, 3, f);
+    total += n + pad.size() + 3;
+  }
+
+  std::fclose(f);
+  return total;
+}
+
+}  // namespace jsonl::bench
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace jsonl::bench {
+
+// Deterministic generator for a synthetic requests.jsonl.
+//
+// Records carry the production hot fields (timestamp, endpoint, latency_ms,
+// status, user_id) plus a filler field that pads each record to roughly
+// `record_bytes`, so benchmarks can sweep record size while keeping the
+// field mix realistic. The same seed always produces byte-identical output,
+// which keeps benchmark runs comparable across machines and revisions.
+struct SyntheticLogOptions {
+  std::uint64_t record_count = 100'000;
+  std::size_t record_bytes = 256;  // approximate, including padding
+  std::uint64_t seed = 42;
+};
+
+// Writes the log to `path`. Returns the total bytes written.
+std::uint64_t write_synthetic_log(const std::string& path,
+                                  const SyntheticLogOptions& options);
+
+}  // namespace jsonl::bench
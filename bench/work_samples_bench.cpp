@@ -0,0 +1,158 @@
+// Scan-path benchmarks. These are the numbers internal rollouts gate on:
+// raw read throughput, newline/structural scan, lazy parse, parallel scan
+// scaling, and index lookup latency. All inputs come from the deterministic
+// synthetic generator so results are reproducible.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <string>
+
+#include "io/mapped_reader.h"
+#include "index/line_index.h"
+#include "parse/lazy_document.h"
+#include "scan/parallel_scanner.h"
+#include "scan/structural_index.h"
+#include "synthetic_log.h"
+
+namespace {
+
+// One shared input per record size; generated lazily, removed at exit.
+class Corpus {
+ public:
+  static const Corpus& get(std::size_t record_bytes) {
+    static Corpus small(256), large(4096);
+    return record_bytes >= 4096 ? large : small;
+  }
+
+  const std::string& path() const { return path_; }
+  const std::string& index_path() const { return index_path_; }
+  std::uint64_t bytes() const { return bytes_; }
+  std::uint64_t records() const { return records_; }
+
+ private:
+  explicit Corpus(std::size_t record_bytes) {
+    path_ = "/tmp/work_samples_bench_" + std::to_string(record_bytes) +
+            ".jsonl";
+    index_path_ = path_ + ".idx";
+    jsonl::bench::SyntheticLogOptions opt;
+    opt.record_bytes = record_bytes;
+    opt.record_count = 64ull * 1024 * 1024 / record_bytes;  // ~64 MiB
+    records_ = opt.record_count;
+    bytes_ = jsonl::bench::write_synthetic_log(path_, opt);
+    jsonl::LineIndexBuilder::build(path_, index_path_);
+  }
+  ~Corpus() {
+    std::remove(path_.c_str());
+    std::remove(index_path_.c_str());
+  }
+
+  std::string path_;
+  std::string index_path_;
+  std::uint64_t bytes_ = 0;
+  std::uint64_t records_ = 0;
+};
+
+void BM_RawReadThroughput(benchmark::State& state) {
+  const Corpus& c = Corpus::get(state.range(0));
+  for (auto _ : state) {
+    jsonl::MappedReader reader(c.path());
+    std::uint64_t sum = 0;
+    std::string_view data = reader.data();
+    for (std::size_t i = 0; i < data.size(); i += 64) sum += data[i];
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetBytesProcessed(state.iterations() * c.bytes());
+}
+BENCHMARK(BM_RawReadThroughput)->Arg(256)->Arg(4096);
+
+void BM_NewlineScan(benchmark::State& state) {
+  const Corpus& c = Corpus::get(state.range(0));
+  jsonl::MappedReader reader(c.path());
+  for (auto _ : state) {
+    auto cursor = reader.lines();
+    std::string_view line;
+    std::uint64_t lines = 0;
+    while (cursor.next(line)) ++lines;
+    benchmark::DoNotOptimize(lines);
+  }
+  state.SetBytesProcessed(state.iterations() * c.bytes());
+}
+BENCHMARK(BM_NewlineScan)->Arg(256)->Arg(4096);
+
+void BM_StructuralScan(benchmark::State& state) {
+  const Corpus& c = Corpus::get(state.range(0));
+  jsonl::MappedReader reader(c.path());
+  jsonl::StructuralIndex index;
+  for (auto _ : state) {
+    index.build(reader.data());
+    benchmark::DoNotOptimize(index.newlines().size());
+  }
+  state.SetBytesProcessed(state.iterations() * c.bytes());
+  state.SetLabel(jsonl::StructuralIndex::active_kernel());
+}
+BENCHMARK(BM_StructuralScan)->Arg(256)->Arg(4096);
+
+void BM_LazyParseTwoFields(benchmark::State& state) {
+  const Corpus& c = Corpus::get(state.range(0));
+  jsonl::MappedReader reader(c.path());
+  jsonl::Arena arena;
+  for (auto _ : state) {
+    auto cursor = reader.lines();
+    std::string_view record;
+    std::int64_t sum = 0;
+    std::size_t n = 0;
+    while (cursor.next(record)) {
+      jsonl::LazyDocument doc(record, arena);
+      sum += doc["latency_ms"].as_int64();
+      sum += doc["status"].as_int64();
+      if (++n % 4096 == 0) arena.reset();
+    }
+    arena.reset();
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetBytesProcessed(state.iterations() * c.bytes());
+}
+BENCHMARK(BM_LazyParseTwoFields)->Arg(256)->Arg(4096);
+
+void BM_ParallelScan(benchmark::State& state) {
+  const Corpus& c = Corpus::get(256);
+  jsonl::MappedReader reader(c.path());
+  jsonl::ScanOptions opt;
+  opt.threads = static_cast<unsigned>(state.range(0));
+  jsonl::ParallelScanner scanner(opt);
+  // Per-worker counters, padded to a cache line: one shared atomic would
+  // make the high-thread-count points measure contention on the
+  // benchmark's own counter instead of scan scaling.
+  struct alignas(64) WorkerCount {
+    std::uint64_t records = 0;
+  };
+  for (auto _ : state) {
+    std::vector<WorkerCount> counts(scanner.thread_count());
+    scanner.scan(reader, [&](std::string_view, std::uint64_t,
+                             unsigned worker) { ++counts[worker].records; });
+    std::uint64_t records = 0;
+    for (const WorkerCount& w : counts) records += w.records;
+    benchmark::DoNotOptimize(records);
+  }
+  state.SetBytesProcessed(state.iterations() * c.bytes());
+}
+BENCHMARK(BM_ParallelScan)->RangeMultiplier(2)->Range(1, 64)->UseRealTime();
+
+void BM_IndexLookup(benchmark::State& state) {
+  const Corpus& c = Corpus::get(256);
+  jsonl::LineIndex index(c.index_path());
+  std::uint64_t i = 0;
+  const std::uint64_t n = index.record_count();
+  for (auto _ : state) {
+    // Pseudo-random walk over record numbers.
+    i = (i * 6364136223846793005ull + 1442695040888963407ull) % n;
+    benchmark::DoNotOptimize(index.range(i));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IndexLookup);
+
+}  // namespace
+
+BENCHMARK_MAIN();
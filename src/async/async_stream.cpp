@@ -0,0 +1,67 @@
+#include "async/async_stream.h"
+
+#include <chrono>
+#include <thread>
+#include <utility>
+
+namespace jsonl {
+
+void Executor::spawn(Task task) {
+  ready_.push_back(task.handle_);
+  tasks_.push_back(std::move(task));
+}
+
+void Executor::park(std::coroutine_handle<> handle,
+                    std::function<bool()> ready) {
+  parked_.push_back(Parked{handle, std::move(ready)});
+}
+
+void Executor::run() {
+  while (!ready_.empty() || !parked_.empty()) {
+    // Resume everything currently runnable. Coroutines that suspend again
+    // re-enter parked_ from inside resume().
+    std::size_t runnable = ready_.size();
+    while (runnable-- > 0) {
+      std::coroutine_handle<> h = ready_.front();
+      ready_.pop_front();
+      h.resume();
+    }
+
+    // Re-arm parked coroutines whose probe has turned true. The probes
+    // themselves drive progress (poll_next reaps completions), so this
+    // pass doubles as the I/O pump.
+    bool progressed = false;
+    for (std::size_t i = 0; i < parked_.size();) {
+      if (parked_[i].ready()) {
+        ready_.push_back(parked_[i].handle);
+        parked_[i] = std::move(parked_.back());
+        parked_.pop_back();
+        progressed = true;
+      } else {
+        ++i;
+      }
+    }
+    if (!progressed && ready_.empty() && !parked_.empty()) {
+      // Everything is waiting on in-flight I/O or external work; nap
+      // briefly rather than spinning a core.
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+  }
+
+  std::vector<Task> finished = std::move(tasks_);
+  tasks_.clear();
+  for (const Task& t : finished) {
+    if (t.handle_ && t.handle_.promise().error) {
+      std::rethrow_exception(t.handle_.promise().error);
+    }
+  }
+}
+
+AsyncStream::AsyncStream(const std::string& path, Executor& executor)
+    : AsyncStream(path, executor, UringReader::Options{}) {}
+
+AsyncStream::AsyncStream(const std::string& path, Executor& executor,
+                         const UringReader::Options& options)
+    : reader_(path, options), executor_(&executor) {}
+
+}  // namespace jsonl
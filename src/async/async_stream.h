@@ -0,0 +1,182 @@
+#pragma once
+
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "io/uring_reader.h"
+
+namespace jsonl {
+
+// Coroutine plumbing for consumers that interleave record processing with
+// slow external work (enrichment lookups). A blocked-thread-per-record
+// design burns hundreds of threads mostly waiting; here one Executor
+// thread multiplexes thousands of suspended coroutines, resuming each only
+// when its I/O is ready.
+//
+//   Executor ex;
+//   AsyncStream stream("requests.jsonl", ex);
+//   ex.spawn([](AsyncStream& s, Executor& ex) -> Task {
+//     while (auto rec = co_await s.next()) {
+//       co_await ex.until([&] { return lookup_done(*rec); });
+//       emit(*rec);
+//     }
+//   }(stream, ex));
+//   ex.run();
+//
+// Scaling beyond one core is by running one Executor per thread, each with
+// its own streams — nothing here is shared between threads.
+
+// Eager-start-free task handle: the coroutine body runs only once the
+// Executor resumes it. Exceptions surface from Executor::run().
+class Task {
+ public:
+  struct promise_type {
+    Task get_return_object() {
+      return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { error = std::current_exception(); }
+
+    std::exception_ptr error;
+  };
+
+  Task(Task&& other) noexcept : handle_(other.handle_) {
+    other.handle_ = nullptr;
+  }
+  Task& operator=(Task&& other) noexcept {
+    if (this != &other) {
+      if (handle_) handle_.destroy();
+      handle_ = other.handle_;
+      other.handle_ = nullptr;
+    }
+    return *this;
+  }
+  ~Task() {
+    if (handle_) handle_.destroy();
+  }
+
+  Task(const Task&) = delete;
+  Task& operator=(const Task&) = delete;
+
+ private:
+  friend class Executor;
+  explicit Task(std::coroutine_handle<promise_type> handle)
+      : handle_(handle) {}
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+// Single-threaded run loop. Ready coroutines resume in FIFO order; parked
+// ones re-arm when their readiness probe turns true (probes are re-polled
+// once per pass, which for AsyncStream also reaps io_uring completions).
+class Executor {
+ public:
+  Executor() = default;
+
+  Executor(const Executor&) = delete;
+  Executor& operator=(const Executor&) = delete;
+
+  // Takes ownership; the task starts on the next run() pass.
+  void spawn(Task task);
+
+  // Runs until every spawned task completes, then rethrows the first
+  // task exception, if any.
+  void run();
+
+  // Awaitable: unconditionally hands the thread back to the run loop and
+  // rejoins the back of the ready queue — the cooperative yield for tasks
+  // that poll something themselves. until(f) with an already-true probe
+  // deliberately does NOT suspend; use this instead inside polling loops.
+  auto yield() {
+    struct Awaiter {
+      Executor* ex;
+      bool await_ready() const noexcept { return false; }
+      void await_suspend(std::coroutine_handle<> h) {
+        ex->ready_.push_back(h);
+      }
+      void await_resume() const noexcept {}
+    };
+    return Awaiter{this};
+  }
+
+  // Awaitable: suspends the caller until `ready()` returns true.
+  auto until(std::function<bool()> ready) {
+    struct Awaiter {
+      Executor* ex;
+      std::function<bool()> ready;
+      bool await_ready() const { return ready(); }
+      void await_suspend(std::coroutine_handle<> h) {
+        ex->park(h, std::move(ready));
+      }
+      void await_resume() const noexcept {}
+    };
+    return Awaiter{this, std::move(ready)};
+  }
+
+ private:
+  friend class AsyncStream;
+
+  struct Parked {
+    std::coroutine_handle<> handle;
+    std::function<bool()> ready;
+  };
+
+  void park(std::coroutine_handle<> handle, std::function<bool()> ready);
+
+  std::deque<std::coroutine_handle<>> ready_;
+  std::vector<Parked> parked_;
+  std::vector<Task> tasks_;
+};
+
+// Async record source over the io_uring backend. next() resolves
+// immediately while prefetched blocks hold records and suspends the
+// awaiting coroutine when the head block is still in flight, so one
+// thread's worth of streams keeps the device queue full. The yielded view
+// follows the Reader contract: valid until the stream's next poll.
+class AsyncStream {
+ public:
+  AsyncStream(const std::string& path, Executor& executor);
+  AsyncStream(const std::string& path, Executor& executor,
+              const UringReader::Options& options);
+
+  // co_await yields the next record, or nullopt at end of file.
+  auto next() {
+    struct Awaiter {
+      AsyncStream* stream;
+      UringReader::Poll state = UringReader::Poll::kPending;
+      std::string_view record{};
+
+      bool await_ready() {
+        state = stream->reader_.poll_next(record);
+        return state != UringReader::Poll::kPending;
+      }
+      void await_suspend(std::coroutine_handle<> h) {
+        stream->executor_->park(h, [this] {
+          state = stream->reader_.poll_next(record);
+          return state != UringReader::Poll::kPending;
+        });
+      }
+      std::optional<std::string_view> await_resume() const {
+        if (state == UringReader::Poll::kReady) return record;
+        return std::nullopt;
+      }
+    };
+    return Awaiter{this};
+  }
+
+  std::uint64_t offset() const noexcept { return reader_.offset(); }
+
+ private:
+  UringReader reader_;
+  Executor* executor_;
+};
+
+}  // namespace jsonl
@@ -0,0 +1,306 @@
+#include "columnar/column_set.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <unordered_map>
+
+#include "parse/lazy_document.h"
+
+namespace jsonl {
+
+namespace {
+
+constexpr std::uint32_t kMagic = 0x314a4c43;  // 'CLJ1' on disk
+constexpr std::uint32_t kVersion = 1;
+constexpr std::size_t kNameBytes = 64;
+
+struct Header {
+  std::uint32_t magic;
+  std::uint32_t version;
+  std::uint32_t column_count;
+  std::uint32_t reserved;
+  std::uint64_t row_count;
+};
+static_assert(sizeof(Header) == 24);
+
+struct DirEntry {
+  char name[kNameBytes];
+  std::uint32_t type;
+  std::uint32_t reserved;
+  std::uint64_t data_offset;
+  std::uint64_t data_size;
+  std::uint64_t aux_offset;
+  std::uint64_t aux_size;
+};
+static_assert(sizeof(DirEntry) == kNameBytes + 40);
+
+[[noreturn]] void throw_errno(const std::string& what) {
+  throw std::system_error(errno, std::generic_category(), what);
+}
+
+[[noreturn]] void malformed(const std::string& path, const char* why) {
+  throw std::runtime_error(path + ": not a column set (" + why + ")");
+}
+
+void write_all(std::FILE* f, const void* p, std::size_t n,
+               const std::string& path) {
+  if (n != 0 && std::fwrite(p, 1, n, f) != n) throw_errno("write " + path);
+}
+
+std::size_t align8(std::size_t n) noexcept { return (n + 7) & ~std::size_t{7}; }
+
+// Reset the parse arena every so many records; per-record reset would waste
+// the block-reuse fast path, per-file would grow without bound.
+constexpr std::size_t kArenaBatch = 4096;
+
+}  // namespace
+
+ColumnSet::ColumnSet(const std::string& path) : map_(path) {
+  std::string_view bytes = map_.data();
+  if (bytes.size() < sizeof(Header)) malformed(path, "truncated");
+  Header h;
+  std::memcpy(&h, bytes.data(), sizeof(h));
+  if (h.magic != kMagic || h.version != kVersion) malformed(path, "bad magic");
+  row_count_ = h.row_count;
+
+  std::size_t dir_end =
+      sizeof(Header) + std::size_t{h.column_count} * sizeof(DirEntry);
+  if (bytes.size() < dir_end) malformed(path, "truncated directory");
+
+  columns_.reserve(h.column_count);
+  for (std::uint32_t i = 0; i < h.column_count; ++i) {
+    DirEntry e;
+    std::memcpy(&e, bytes.data() + sizeof(Header) + i * sizeof(DirEntry),
+                sizeof(e));
+    if (e.data_offset + e.data_size > bytes.size() ||
+        e.aux_offset + e.aux_size > bytes.size()) {
+      malformed(path, "blob out of range");
+    }
+    Column c;
+    c.name.assign(e.name, strnlen(e.name, kNameBytes));
+    c.type = static_cast<ColumnType>(e.type);
+    c.data = bytes.substr(e.data_offset, e.data_size);
+    c.aux = bytes.substr(e.aux_offset, e.aux_size);
+
+    // The range check above only bounds the blobs against the file; a
+    // dict column's aux must also be internally consistent, or value()
+    // reads out of bounds on a truncated or corrupt sidecar.
+    if (c.type == ColumnType::kDict) {
+      if (c.aux.size() < sizeof(std::uint32_t)) {
+        malformed(path, "dict table truncated");
+      }
+      std::uint32_t cardinality;
+      std::memcpy(&cardinality, c.aux.data(), sizeof(cardinality));
+      const std::size_t table_bytes =
+          sizeof(std::uint32_t) * (std::size_t{cardinality} + 2);
+      if (c.aux.size() < table_bytes) {
+        malformed(path, "dict table truncated");
+      }
+      const std::uint32_t* offsets = reinterpret_cast<const std::uint32_t*>(
+          c.aux.data() + sizeof(std::uint32_t));
+      const std::size_t string_bytes = c.aux.size() - table_bytes;
+      std::uint32_t prev = 0;
+      for (std::uint32_t k = 0; k <= cardinality; ++k) {
+        if (offsets[k] < prev || offsets[k] > string_bytes) {
+          malformed(path, "dict offsets out of range");
+        }
+        prev = offsets[k];
+      }
+    }
+    columns_.push_back(std::move(c));
+  }
+}
+
+const ColumnSet::Column& ColumnSet::find(std::string_view name,
+                                         ColumnType type) const {
+  for (const Column& c : columns_) {
+    if (c.name == name) {
+      if (c.type != type) {
+        throw std::runtime_error("column '" + c.name + "': wrong type");
+      }
+      return c;
+    }
+  }
+  throw std::runtime_error("column '" + std::string(name) + "': not found");
+}
+
+std::span<const std::int64_t> ColumnSet::int64_column(
+    std::string_view name) const {
+  const Column& c = find(name, ColumnType::kInt64);
+  return {reinterpret_cast<const std::int64_t*>(c.data.data()),
+          c.data.size() / sizeof(std::int64_t)};
+}
+
+std::span<const double> ColumnSet::float64_column(std::string_view name) const {
+  const Column& c = find(name, ColumnType::kFloat64);
+  return {reinterpret_cast<const double*>(c.data.data()),
+          c.data.size() / sizeof(double)};
+}
+
+ColumnSet::DictColumn ColumnSet::dict_column(std::string_view name) const {
+  const Column& c = find(name, ColumnType::kDict);
+  DictColumn d;
+  d.codes = {reinterpret_cast<const std::uint32_t*>(c.data.data()),
+             c.data.size() / sizeof(std::uint32_t)};
+  std::memcpy(&d.cardinality, c.aux.data(), sizeof(d.cardinality));
+  d.offsets =
+      reinterpret_cast<const std::uint32_t*>(c.aux.data() + sizeof(std::uint32_t));
+  d.bytes = c.aux.data() + sizeof(std::uint32_t) +
+            (std::size_t{d.cardinality} + 1) * sizeof(std::uint32_t);
+  return d;
+}
+
+std::uint64_t ColumnSetBuilder::convert(const std::string& jsonl_path,
+                                        const std::string& out_path,
+                                        const std::vector<ColumnSpec>& specs) {
+  for (const ColumnSpec& s : specs) {
+    if (s.name.size() >= kNameBytes) {
+      throw std::runtime_error("column name too long: " + s.name);
+    }
+  }
+
+  struct Build {
+    std::vector<std::int64_t> i64;
+    std::vector<double> f64;
+    std::vector<std::uint32_t> codes;
+    std::unordered_map<std::string, std::uint32_t> dict;
+    std::vector<std::string> dict_order;
+  };
+  std::vector<Build> builds(specs.size());
+  for (std::size_t c = 0; c < specs.size(); ++c) {
+    if (specs[c].type == ColumnType::kDict) {
+      builds[c].dict.emplace("", 0);
+      builds[c].dict_order.emplace_back("");
+    }
+  }
+
+  MappedReader reader(jsonl_path);
+  Arena arena;
+  auto cursor = reader.lines();
+  std::string_view record;
+  std::uint64_t rows = 0;
+  while (cursor.next(record)) {
+    LazyDocument doc(record, arena);
+    for (std::size_t c = 0; c < specs.size(); ++c) {
+      Value v = doc[specs[c].name];
+      Build& b = builds[c];
+      switch (specs[c].type) {
+        case ColumnType::kInt64:
+          b.i64.push_back(v.as_int64());
+          break;
+        case ColumnType::kFloat64:
+          b.f64.push_back(v.as_double());
+          break;
+        case ColumnType::kDict: {
+          std::string key(v.as_string());
+          auto [it, fresh] =
+              b.dict.emplace(key, static_cast<std::uint32_t>(b.dict.size()));
+          if (fresh) b.dict_order.push_back(key);
+          b.codes.push_back(it->second);
+          break;
+        }
+      }
+    }
+    if (++rows % kArenaBatch == 0) arena.reset();
+  }
+
+  // Lay out blobs after the directory.
+  std::vector<DirEntry> dir(specs.size());
+  std::size_t blob_at =
+      align8(sizeof(Header) + specs.size() * sizeof(DirEntry));
+
+  struct Blob {
+    const void* data;
+    std::size_t size;
+  };
+  std::vector<Blob> blobs;
+  std::vector<std::vector<char>> aux_storage(specs.size());
+
+  for (std::size_t c = 0; c < specs.size(); ++c) {
+    DirEntry& e = dir[c];
+    std::memset(&e, 0, sizeof(e));
+    std::memcpy(e.name, specs[c].name.data(), specs[c].name.size());
+    e.type = static_cast<std::uint32_t>(specs[c].type);
+
+    const Build& b = builds[c];
+    Blob data{nullptr, 0};
+    switch (specs[c].type) {
+      case ColumnType::kInt64:
+        data = {b.i64.data(), b.i64.size() * sizeof(std::int64_t)};
+        break;
+      case ColumnType::kFloat64:
+        data = {b.f64.data(), b.f64.size() * sizeof(double)};
+        break;
+      case ColumnType::kDict:
+        data = {b.codes.data(), b.codes.size() * sizeof(std::uint32_t)};
+        break;
+    }
+    e.data_offset = blob_at;
+    e.data_size = data.size;
+    blobs.push_back(data);
+    blob_at = align8(blob_at + data.size);
+
+    if (specs[c].type == ColumnType::kDict) {
+      // Serialize dictionary: count, offsets[count + 1], bytes.
+      std::vector<char>& out = aux_storage[c];
+      const std::uint32_t count =
+          static_cast<std::uint32_t>(b.dict_order.size());
+      std::vector<std::uint32_t> offsets(count + 1);
+      std::uint32_t at = 0;
+      for (std::uint32_t i = 0; i < count; ++i) {
+        offsets[i] = at;
+        at += static_cast<std::uint32_t>(b.dict_order[i].size());
+      }
+      offsets[count] = at;
+      out.resize(sizeof(count) + offsets.size() * sizeof(std::uint32_t) + at);
+      char* p = out.data();
+      std::memcpy(p, &count, sizeof(count));
+      p += sizeof(count);
+      std::memcpy(p, offsets.data(), offsets.size() * sizeof(std::uint32_t));
+      p += offsets.size() * sizeof(std::uint32_t);
+      for (const std::string& s : b.dict_order) {
+        std::memcpy(p, s.data(), s.size());
+        p += s.size();
+      }
+      e.aux_offset = blob_at;
+      e.aux_size = out.size();
+      blob_at = align8(blob_at + out.size());
+    }
+  }
+
+  std::FILE* f = std::fopen(out_path.c_str(), "wb");
+  if (f == nullptr) throw_errno("open " + out_path);
+  try {
+    Header h{kMagic, kVersion, static_cast<std::uint32_t>(specs.size()), 0,
+             rows};
+    write_all(f, &h, sizeof(h), out_path);
+    write_all(f, dir.data(), dir.size() * sizeof(DirEntry), out_path);
+
+    const char pad[8] = {};
+    std::size_t at = sizeof(Header) + dir.size() * sizeof(DirEntry);
+    auto pad_to = [&](std::size_t target) {
+      write_all(f, pad, target - at, out_path);
+      at = target;
+    };
+    for (std::size_t c = 0; c < specs.size(); ++c) {
+      pad_to(dir[c].data_offset);
+      write_all(f, blobs[c].data, blobs[c].size, out_path);
+      at += blobs[c].size;
+      if (specs[c].type == ColumnType::kDict) {
+        pad_to(dir[c].aux_offset);
+        write_all(f, aux_storage[c].data(), aux_storage[c].size(), out_path);
+        at += aux_storage[c].size();
+      }
+    }
+  } catch (...) {
+    std::fclose(f);
+    throw;
+  }
+  if (std::fclose(f) != 0) throw_errno("close " + out_path);
+  return rows;
+}
+
+}  // namespace jsonl
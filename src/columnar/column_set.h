@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "io/mapped_reader.h"
+
+namespace jsonl {
+
+// Columnar sidecar for hot request fields (`<log>.jsonlc`).
+//
+// Chosen fields are extracted once from the JSONL text into per-column
+// contiguous arrays so aggregations scan dense, cache-friendly memory
+// instead of re-parsing JSON. Numeric columns are packed int64/double
+// arrays; string columns are dictionary-encoded as u32 codes plus a string
+// table, which both shrinks them and turns group-bys into integer
+// comparisons.
+//
+// On-disk layout (little-endian, 8-byte aligned blobs):
+//   Header     { magic 'CLJ1', version, column_count, row_count }
+//   Directory  column_count x { name[64], type, data off/size, aux off/size }
+//   Blobs      column data arrays; for dict columns, aux holds the string
+//              table as u32 count, u32 byte-offsets[count + 1], bytes
+//
+// The reader mmaps the file and returns spans directly into the mapping.
+
+enum class ColumnType : std::uint32_t {
+  kInt64 = 0,
+  kFloat64 = 1,
+  kDict = 2,  // u32 codes into a per-column string dictionary
+};
+
+struct ColumnSpec {
+  std::string name;  // top-level JSON key, at most 63 bytes
+  ColumnType type;
+};
+
+// Read side: maps an existing .jsonlc file.
+class ColumnSet {
+ public:
+  // Throws std::system_error on I/O failure and std::runtime_error if the
+  // file is malformed or a requested column has the wrong type.
+  explicit ColumnSet(const std::string& path);
+
+  std::uint64_t row_count() const noexcept { return row_count_; }
+  std::size_t column_count() const noexcept { return columns_.size(); }
+
+  std::span<const std::int64_t> int64_column(std::string_view name) const;
+  std::span<const double> float64_column(std::string_view name) const;
+
+  struct DictColumn {
+    std::span<const std::uint32_t> codes;  // one per row
+    std::uint32_t cardinality;
+
+    // Dictionary string for a code; code 0 is always the empty string,
+    // used for rows where the field was absent.
+    std::string_view value(std::uint32_t code) const noexcept {
+      if (code >= cardinality) return {};
+      return {bytes + offsets[code], offsets[code + 1] - offsets[code]};
+    }
+
+    const std::uint32_t* offsets;
+    const char* bytes;
+  };
+  DictColumn dict_column(std::string_view name) const;
+
+ private:
+  struct Column {
+    std::string name;
+    ColumnType type;
+    std::string_view data;
+    std::string_view aux;
+  };
+  const Column& find(std::string_view name, ColumnType type) const;
+
+  MappedReader map_;
+  std::uint64_t row_count_ = 0;
+  std::vector<Column> columns_;
+};
+
+// Write side: one streaming pass over the JSONL file.
+class ColumnSetBuilder {
+ public:
+  // Extracts `specs` from every record of `jsonl_path` into `out_path`.
+  // Missing numeric fields store 0; missing strings store dictionary code 0
+  // (the empty string). Returns the row count.
+  static std::uint64_t convert(const std::string& jsonl_path,
+                               const std::string& out_path,
+                               const std::vector<ColumnSpec>& specs);
+};
+
+}  // namespace jsonl
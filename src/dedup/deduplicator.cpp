@@ -0,0 +1,236 @@
+#include "dedup/deduplicator.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <system_error>
+
+#include "parse/lazy_document.h"
+
+namespace jsonl {
+
+namespace {
+
+inline std::uint64_t load64(const char* p) noexcept {
+  std::uint64_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+// 64x64 -> 128 multiply folded to 64 bits; the core xxh3/wyhash mixer.
+inline std::uint64_t mulfold(std::uint64_t a, std::uint64_t b) noexcept {
+  const __uint128_t p = static_cast<__uint128_t>(a) * b;
+  return static_cast<std::uint64_t>(p) ^ static_cast<std::uint64_t>(p >> 64);
+}
+
+constexpr std::uint64_t kSecret[4] = {
+    0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull,
+    0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull};
+
+}  // namespace
+
+Fingerprint fingerprint128(std::string_view bytes) noexcept {
+  const char* p = bytes.data();
+  std::size_t n = bytes.size();
+  std::uint64_t acc0 = kSecret[0] ^ n;
+  std::uint64_t acc1 = kSecret[1] ^ n;
+
+  while (n >= 16) {
+    acc0 = mulfold(load64(p) ^ kSecret[2], acc0);
+    acc1 = mulfold(load64(p + 8) ^ kSecret[3], acc1);
+    p += 16;
+    n -= 16;
+  }
+  // Tail: the last (overlapping) 8-byte words, or a byte-built word for
+  // inputs shorter than 8 bytes.
+  std::uint64_t t0 = 0, t1 = 0;
+  if (n >= 8) {
+    t0 = load64(p);
+    t1 = load64(p + n - 8);
+  } else if (n > 0) {
+    for (std::size_t i = 0; i < n; ++i) {
+      t0 = (t0 << 8) | static_cast<unsigned char>(p[i]);
+    }
+    t1 = t0;
+  }
+  acc0 = mulfold(t0 ^ kSecret[2], acc0 ^ kSecret[1]);
+  acc1 = mulfold(t1 ^ kSecret[3], acc1 ^ kSecret[0]);
+
+  Fingerprint fp{mulfold(acc0, acc1 ^ kSecret[0]),
+                 mulfold(acc1, acc0 ^ kSecret[1])};
+  // Zero is the empty-slot marker; remap the (astronomically rare) hit.
+  if (fp.lo == 0 && fp.hi == 0) fp.lo = 1;
+  return fp;
+}
+
+Deduplicator::Deduplicator() : Deduplicator(Options{}) {}
+
+Deduplicator::Deduplicator(const Options& options) : opt_(options) {
+  entry_budget_ = opt_.max_table_bytes / sizeof(Fingerprint);
+  const std::size_t per_shard =
+      std::max<std::size_t>(1024, entry_budget_ / kShards / 4);
+  std::size_t cap = 1;
+  while (cap < per_shard) cap <<= 1;
+  for (Shard& s : shards_) s.slots.resize(cap);
+}
+
+Fingerprint Deduplicator::fingerprint(std::string_view record,
+                                      Arena& arena) const {
+  if (opt_.fields.empty()) return fingerprint128(record);
+
+  // Concatenate the raw field values with 0x1f separators so ("ab","c")
+  // and ("a","bc") fingerprint differently, then hash once.
+  LazyDocument doc(record, arena);
+  std::string key;
+  key.reserve(64);
+  for (const std::string& f : opt_.fields) {
+    const Value v = doc[f];
+    const std::string_view raw = v.raw();
+    key.append(raw.data(), raw.size());
+    key.push_back('\x1f');
+  }
+  return fingerprint128(key);
+}
+
+bool Deduplicator::insert(std::string_view record, Arena& arena) {
+  records_.fetch_add(1, std::memory_order_relaxed);
+  const bool fresh = insert_fingerprint(fingerprint(record, arena));
+  if (!fresh) duplicates_.fetch_add(1, std::memory_order_relaxed);
+  return fresh;
+}
+
+bool Deduplicator::insert(std::string_view record) {
+  thread_local Arena scratch;
+  scratch.reset();
+  return insert(record, scratch);
+}
+
+bool Deduplicator::insert_fingerprint(Fingerprint fp) {
+  std::shared_lock spill_guard(spill_mutex_);
+  Shard& shard = shards_[fp.hi % kShards];
+  {
+    std::lock_guard lock(shard.mutex);
+    const std::size_t mask = shard.slots.size() - 1;
+    std::size_t i = fp.lo & mask;
+    for (;;) {
+      Fingerprint& slot = shard.slots[i];
+      if (slot == fp) return false;
+      if (slot.lo == 0 && slot.hi == 0) {
+        if (in_spill_runs(fp)) return false;
+        slot = fp;
+        ++shard.size;
+        break;
+      }
+      i = (i + 1) & mask;
+    }
+    // Grow at 70% load unless the global budget says spill instead.
+    if (shard.size * 10 >= shard.slots.size() * 7 &&
+        (opt_.spill_dir.empty() ||
+         total_entries_.load(std::memory_order_relaxed) < entry_budget_)) {
+      std::vector<Fingerprint> grown(shard.slots.size() * 2);
+      const std::size_t gmask = grown.size() - 1;
+      for (const Fingerprint& e : shard.slots) {
+        if (e.lo == 0 && e.hi == 0) continue;
+        std::size_t j = e.lo & gmask;
+        while (!(grown[j].lo == 0 && grown[j].hi == 0)) j = (j + 1) & gmask;
+        grown[j] = e;
+      }
+      shard.slots = std::move(grown);
+    }
+  }
+
+  const std::size_t total =
+      total_entries_.fetch_add(1, std::memory_order_relaxed) + 1;
+  if (!opt_.spill_dir.empty() && total >= entry_budget_) {
+    spill_guard.unlock();
+    spill();
+  }
+  return true;
+}
+
+bool Deduplicator::in_spill_runs(Fingerprint fp) const {
+  for (const MappedReader& run : runs_) {
+    const auto* begin =
+        reinterpret_cast<const Fingerprint*>(run.data().data());
+    const auto* end = begin + run.size() / sizeof(Fingerprint);
+    const auto* it = std::lower_bound(
+        begin, end, fp, [](const Fingerprint& a, const Fingerprint& b) {
+          return a.hi != b.hi ? a.hi < b.hi : a.lo < b.lo;
+        });
+    if (it != end && *it == fp) return true;
+  }
+  return false;
+}
+
+void Deduplicator::spill() {
+  std::unique_lock spill_guard(spill_mutex_);
+  // Another worker may have spilled while we waited for exclusivity.
+  if (total_entries_.load(std::memory_order_relaxed) < entry_budget_) return;
+
+  std::vector<Fingerprint> all;
+  all.reserve(total_entries_.load(std::memory_order_relaxed));
+  for (Shard& s : shards_) {
+    for (const Fingerprint& e : s.slots) {
+      if (!(e.lo == 0 && e.hi == 0)) all.push_back(e);
+    }
+    std::fill(s.slots.begin(), s.slots.end(), Fingerprint{});
+    s.size = 0;
+  }
+  std::sort(all.begin(), all.end(),
+            [](const Fingerprint& a, const Fingerprint& b) {
+              return a.hi != b.hi ? a.hi < b.hi : a.lo < b.lo;
+            });
+
+  const std::string path = opt_.spill_dir + "/dedup-run-" +
+                           std::to_string(runs_.size()) + ".fps";
+  const int fd = ::open(path.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0644);
+  if (fd < 0) {
+    throw std::system_error(errno, std::generic_category(),
+                            "open " + path);
+  }
+  const char* p = reinterpret_cast<const char*>(all.data());
+  std::size_t left = all.size() * sizeof(Fingerprint);
+  while (left > 0) {
+    const ssize_t n = ::write(fd, p, left);
+    if (n < 0) {
+      const int err = errno;
+      ::close(fd);
+      throw std::system_error(err, std::generic_category(), "write " + path);
+    }
+    p += n;
+    left -= static_cast<std::size_t>(n);
+  }
+  ::close(fd);
+
+  runs_.emplace_back(path);
+  total_entries_.store(0, std::memory_order_relaxed);
+}
+
+Deduplicator::Stats Deduplicator::stats() const noexcept {
+  Stats s;
+  s.records = records_.load(std::memory_order_relaxed);
+  s.duplicates = duplicates_.load(std::memory_order_relaxed);
+  std::shared_lock spill_guard(spill_mutex_);
+  s.spill_runs = runs_.size();
+  return s;
+}
+
+void scan_unique(const ParallelScanner& scanner, const MappedReader& reader,
+                 Deduplicator& dedup, const ParallelScanner::RecordFn& fn) {
+  constexpr std::size_t kArenaBatch = 4096;
+  struct WorkerState {
+    Arena arena;
+    std::size_t records = 0;
+  };
+  std::vector<WorkerState> states(scanner.thread_count());
+  scanner.scan(reader, [&](std::string_view record, std::uint64_t offset,
+                           unsigned worker) {
+    WorkerState& st = states[worker];
+    if (dedup.insert(record, st.arena)) fn(record, offset, worker);
+    if (++st.records % kArenaBatch == 0) st.arena.reset();
+  });
+}
+
+}  // namespace jsonl
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "io/log_writer.h"
+#include "io/mapped_reader.h"
+#include "parse/arena.h"
+#include "scan/parallel_scanner.h"
+
+namespace jsonl {
+
+// 128-bit record fingerprint. Collisions across a 2^64-record corpus are
+// vanishingly unlikely, so fingerprint equality stands in for record
+// equality; no raw bytes are retained.
+struct Fingerprint {
+  std::uint64_t lo = 0;
+  std::uint64_t hi = 0;
+
+  friend bool operator==(const Fingerprint&, const Fingerprint&) = default;
+};
+
+// Computes the fingerprint of a raw byte slice (mul-fold construction in
+// the xxh3/wyhash family; local implementation, no external dependency).
+Fingerprint fingerprint128(std::string_view bytes) noexcept;
+
+// Streaming record deduplication.
+//
+// Upstream retries duplicate a few percent of ingested records; this stage
+// drops repeats in one pass instead of a sort. Each record is reduced to a
+// 128-bit fingerprint — over the whole line, or over the values of a
+// configured field subset when only those define identity — and tracked in
+// a sharded open-addressing set at 16 bytes per unique record.
+//
+// For full-log runs whose unique set exceeds max_table_bytes, configure
+// spill_dir: the in-memory set is then sorted and flushed to a run file
+// whenever it reaches the budget, and a miss in memory falls back to a
+// binary search of each mapped run before a record is declared new.
+// Without a spill_dir the table simply grows.
+//
+// insert() is safe to call from concurrent scan workers; spills briefly
+// stop the world via a shared_mutex.
+class Deduplicator {
+ public:
+  struct Options {
+    // Fields whose values define record identity; empty means the whole
+    // record line is the identity.
+    std::vector<std::string> fields;
+    std::size_t max_table_bytes = 256u << 20;
+    std::string spill_dir;  // empty: never spill, grow in memory
+  };
+
+  Deduplicator();
+  explicit Deduplicator(const Options& options);
+
+  Deduplicator(const Deduplicator&) = delete;
+  Deduplicator& operator=(const Deduplicator&) = delete;
+
+  // Returns true if this record has not been seen before (and records it).
+  // The arena backs field extraction and is not reset here.
+  bool insert(std::string_view record, Arena& arena);
+
+  // Convenience overload using a per-thread scratch arena.
+  bool insert(std::string_view record);
+
+  struct Stats {
+    std::uint64_t records = 0;
+    std::uint64_t duplicates = 0;
+    std::uint64_t spill_runs = 0;
+  };
+  Stats stats() const noexcept;
+
+ private:
+  static constexpr std::size_t kShards = 64;
+
+  struct Shard {
+    std::mutex mutex;
+    std::vector<Fingerprint> slots;  // empty slot = zero fingerprint
+    std::size_t size = 0;
+  };
+
+  Fingerprint fingerprint(std::string_view record, Arena& arena) const;
+  bool insert_fingerprint(Fingerprint fp);
+  bool in_spill_runs(Fingerprint fp) const;
+  void spill();
+
+  Options opt_;
+  Shard shards_[kShards];
+  std::atomic<std::size_t> total_entries_{0};
+  std::size_t entry_budget_ = 0;  // max_table_bytes / sizeof(Fingerprint)
+
+  mutable std::shared_mutex spill_mutex_;  // exclusive only while spilling
+  std::vector<MappedReader> runs_;
+
+  std::atomic<std::uint64_t> records_{0};
+  std::atomic<std::uint64_t> duplicates_{0};
+};
+
+// Ingest adapter: forwards first occurrences to the writer, drops repeats.
+class DedupWriter {
+ public:
+  DedupWriter(LogWriter& writer, Deduplicator& dedup)
+      : writer_(writer), dedup_(dedup) {}
+
+  void append(std::string_view record) {
+    if (dedup_.insert(record)) writer_.append(record);
+  }
+
+ private:
+  LogWriter& writer_;
+  Deduplicator& dedup_;
+};
+
+// Deduplicating parallel scan: delivers only the first occurrence of each
+// record to `fn`. Which duplicate survives is scan-order dependent; the
+// set of surviving identities is not.
+void scan_unique(const ParallelScanner& scanner, const MappedReader& reader,
+                 Deduplicator& dedup, const ParallelScanner::RecordFn& fn);
+
+}  // namespace jsonl
@@ -0,0 +1,204 @@
+#include "index/bloom_index.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#include "index/line_index.h"
+#include "parse/lazy_document.h"
+
+namespace jsonl {
+
+namespace {
+
+constexpr std::uint32_t kMagic = 0x46424c4a;  // 'JLBF' on disk
+constexpr std::uint32_t kVersion = 1;
+constexpr std::size_t kNameBytes = 64;
+
+struct Header {
+  std::uint32_t magic;
+  std::uint32_t version;
+  std::uint64_t chunk_bytes;
+  std::uint64_t filter_bytes;
+  std::uint32_t chunk_count;
+  std::uint32_t field_count;
+  std::uint32_t hash_count;
+  std::uint32_t reserved;
+};
+static_assert(sizeof(Header) == 40);
+
+// Double hashing (Kirsch-Mitzenmacher): bit_i = h1 + i * h2. The field
+// name is folded into the seed so values of different fields never alias.
+struct HashPair {
+  std::uint64_t h1;
+  std::uint64_t h2;
+};
+
+std::uint64_t fnv1a(std::string_view s, std::uint64_t h) noexcept {
+  for (char c : s) {
+    h ^= static_cast<unsigned char>(c);
+    h *= 0x100000001b3ull;
+  }
+  return h;
+}
+
+HashPair hash_field_value(std::string_view field,
+                          std::string_view value) noexcept {
+  const std::uint64_t seed = fnv1a(field, 0xcbf29ce484222325ull);
+  const std::uint64_t h1 = fnv1a(value, seed);
+  std::uint64_t h2 = fnv1a(value, seed ^ 0x9e3779b97f4a7c15ull);
+  h2 |= 1;  // keep the stride odd
+  return {h1, h2};
+}
+
+constexpr std::size_t kArenaBatch = 4096;
+
+}  // namespace
+
+BloomIndex::BloomIndex(const std::string& bf_path) : map_(bf_path) {
+  const std::string_view bytes = map_.data();
+  if (bytes.size() < sizeof(Header)) {
+    throw std::runtime_error(bf_path + ": not a bloom index");
+  }
+  Header h;
+  std::memcpy(&h, bytes.data(), sizeof(h));
+  const std::uint64_t expect =
+      sizeof(Header) + std::uint64_t{h.field_count} * kNameBytes +
+      std::uint64_t{h.chunk_count} * h.filter_bytes;
+  if (h.magic != kMagic || h.version != kVersion || bytes.size() < expect) {
+    throw std::runtime_error(bf_path + ": not a bloom index");
+  }
+  chunk_bytes_ = h.chunk_bytes;
+  chunk_count_ = h.chunk_count;
+  hash_count_ = h.hash_count;
+  filter_bytes_ = h.filter_bytes;
+  for (std::uint32_t i = 0; i < h.field_count; ++i) {
+    const char* name = bytes.data() + sizeof(Header) + i * kNameBytes;
+    fields_.emplace_back(name, strnlen(name, kNameBytes));
+  }
+  filters_ = reinterpret_cast<const std::uint8_t*>(
+      bytes.data() + sizeof(Header) + h.field_count * kNameBytes);
+}
+
+bool BloomIndex::may_contain(std::uint32_t chunk, std::string_view field,
+                             std::string_view value) const noexcept {
+  if (chunk >= chunk_count_) return false;
+  const std::uint8_t* filter = filters_ + chunk * filter_bytes_;
+  const std::uint64_t bits = filter_bytes_ * 8;
+  HashPair h = hash_field_value(field, value);
+  for (std::uint32_t i = 0; i < hash_count_; ++i) {
+    const std::uint64_t bit = (h.h1 + i * h.h2) % bits;
+    if ((filter[bit >> 3] & (1u << (bit & 7))) == 0) return false;
+  }
+  return true;
+}
+
+std::function<bool(std::uint64_t, std::uint64_t)> BloomIndex::chunk_predicate(
+    std::string field, std::string value) const {
+  return [this, field = std::move(field),
+          value = std::move(value)](std::uint64_t begin, std::uint64_t end) {
+    const std::uint32_t first = static_cast<std::uint32_t>(begin / chunk_bytes_);
+    const std::uint32_t last = end == begin
+                                   ? first
+                                   : static_cast<std::uint32_t>(
+                                         (end - 1) / chunk_bytes_);
+    for (std::uint32_t c = first; c <= last && c < chunk_count_; ++c) {
+      if (may_contain(c, field, value)) return true;
+    }
+    return false;
+  };
+}
+
+void BloomIndexBuilder::build(const std::string& jsonl_path,
+                              const std::string& bf_path,
+                              const std::vector<std::string>& fields,
+                              const std::string& idx_path) {
+  build(jsonl_path, bf_path, fields, idx_path, Options());
+}
+
+void BloomIndexBuilder::build(const std::string& jsonl_path,
+                              const std::string& bf_path,
+                              const std::vector<std::string>& fields,
+                              const std::string& idx_path,
+                              const Options& options) {
+  for (const std::string& f : fields) {
+    if (f.size() >= kNameBytes) {
+      throw std::runtime_error("bloom field name too long: " + f);
+    }
+  }
+
+  MappedReader reader(jsonl_path);
+  const std::string_view bytes = reader.data();
+  const std::uint32_t chunk_count = static_cast<std::uint32_t>(
+      (bytes.size() + options.chunk_bytes - 1) / options.chunk_bytes);
+
+  std::vector<std::uint8_t> filters(
+      std::size_t{chunk_count} * options.filter_bytes, 0);
+  const std::uint64_t bits = options.filter_bytes * 8;
+
+  std::vector<std::uint64_t> offsets;
+  const bool want_idx = !idx_path.empty();
+
+  Arena arena;
+  auto cursor = reader.lines();
+  std::string_view record;
+  std::uint64_t at = 0;
+  std::size_t n = 0;
+  while (true) {
+    const std::uint64_t start = at;
+    if (!cursor.next(record)) break;
+    at = cursor.offset();
+    if (want_idx) offsets.push_back(start);
+
+    const std::uint32_t chunk =
+        static_cast<std::uint32_t>(start / options.chunk_bytes);
+    std::uint8_t* filter = filters.data() + chunk * options.filter_bytes;
+
+    LazyDocument doc(record, arena);
+    for (const std::string& field : fields) {
+      const Value v = doc[field];
+      if (!v) continue;
+      // Index the text form: string contents for strings, raw digits for
+      // numbers, so queries probe with the same bytes they would compare.
+      const std::string_view text =
+          v.type() == ValueType::kString ? v.as_string() : v.raw();
+      HashPair h = hash_field_value(field, text);
+      for (std::uint32_t i = 0; i < options.hash_count; ++i) {
+        const std::uint64_t bit = (h.h1 + i * h.h2) % bits;
+        filter[bit >> 3] |= static_cast<std::uint8_t>(1u << (bit & 7));
+      }
+    }
+    if (++n % kArenaBatch == 0) arena.reset();
+  }
+
+  std::FILE* f = std::fopen(bf_path.c_str(), "wb");
+  if (f == nullptr) {
+    throw std::system_error(errno, std::generic_category(), "open " + bf_path);
+  }
+  bool ok = true;
+  Header h{kMagic,      kVersion,
+           options.chunk_bytes, options.filter_bytes,
+           chunk_count, static_cast<std::uint32_t>(fields.size()),
+           options.hash_count,  0};
+  ok = ok && std::fwrite(&h, 1, sizeof(h), f) == sizeof(h);
+  for (const std::string& field : fields) {
+    char name[kNameBytes] = {};
+    std::memcpy(name, field.data(), field.size());
+    ok = ok && std::fwrite(name, 1, kNameBytes, f) == kNameBytes;
+  }
+  ok = ok && (filters.empty() ||
+              std::fwrite(filters.data(), 1, filters.size(), f) ==
+                  filters.size());
+  if (std::fclose(f) != 0 || !ok) {
+    throw std::system_error(EIO, std::generic_category(), "write " + bf_path);
+  }
+
+  if (want_idx) {
+    offsets.push_back(bytes.size());
+    LineIndexBuilder::write(idx_path, offsets);
+  }
+}
+
+}  // namespace jsonl
@@ -0,0 +1,127 @@
+#include "index/line_index.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+namespace jsonl {
+
+namespace {
+
+constexpr std::uint32_t kMagic = 0x4a4c4958;  // 'XILJ' on disk
+constexpr std::uint32_t kVersion = 1;
+constexpr std::uint32_t kBlockShift = 16;
+
+struct Header {
+  std::uint32_t magic;
+  std::uint32_t version;
+  std::uint32_t block_shift;
+  std::uint32_t reserved;
+  std::uint64_t record_count;
+  std::uint64_t data_size;
+};
+static_assert(sizeof(Header) == 32);
+
+[[noreturn]] void throw_errno(const std::string& what) {
+  throw std::system_error(errno, std::generic_category(), what);
+}
+
+void write_all(std::FILE* f, const void* p, std::size_t n,
+               const std::string& path) {
+  if (std::fwrite(p, 1, n, f) != n) throw_errno("write " + path);
+}
+
+}  // namespace
+
+LineIndex::LineIndex(const std::string& idx_path) : map_(idx_path) {
+  std::string_view bytes = map_.data();
+  if (bytes.size() < sizeof(Header)) {
+    throw std::runtime_error(idx_path + ": not a line index (truncated)");
+  }
+  Header h;
+  std::memcpy(&h, bytes.data(), sizeof(h));
+  if (h.magic != kMagic || h.version != kVersion) {
+    throw std::runtime_error(idx_path + ": not a line index (bad magic)");
+  }
+  record_count_ = h.record_count;
+  block_shift_ = h.block_shift;
+
+  const std::uint64_t entries = record_count_ + 1;
+  const std::uint64_t blocks =
+      (entries + (std::uint64_t{1} << block_shift_) - 1) >> block_shift_;
+  const std::uint64_t expect =
+      sizeof(Header) + blocks * sizeof(std::uint64_t) +
+      entries * sizeof(std::uint32_t);
+  if (bytes.size() < expect) {
+    throw std::runtime_error(idx_path + ": not a line index (truncated)");
+  }
+  bases_ = reinterpret_cast<const std::uint64_t*>(bytes.data() +
+                                                  sizeof(Header));
+  deltas_ = reinterpret_cast<const std::uint32_t*>(
+      bytes.data() + sizeof(Header) + blocks * sizeof(std::uint64_t));
+}
+
+std::uint64_t LineIndexBuilder::build(const std::string& jsonl_path,
+                                      const std::string& idx_path) {
+  MappedReader reader(jsonl_path);
+  const std::string_view bytes = reader.data();
+
+  // Collect record-start offsets plus the end-of-data sentinel.
+  std::vector<std::uint64_t> offsets;
+  std::size_t pos = 0;
+  while (pos < bytes.size()) {
+    offsets.push_back(pos);
+    const char* nl = static_cast<const char*>(
+        std::memchr(bytes.data() + pos, '\n', bytes.size() - pos));
+    if (nl == nullptr) break;
+    pos = static_cast<std::size_t>(nl - bytes.data()) + 1;
+  }
+  const std::uint64_t record_count = offsets.size();
+  offsets.push_back(bytes.size());
+  write(idx_path, offsets);
+  return record_count;
+}
+
+void LineIndexBuilder::write(
+    const std::string& idx_path,
+    const std::vector<std::uint64_t>& offsets) {
+  const std::uint64_t record_count = offsets.size() - 1;
+  const std::uint64_t block = std::uint64_t{1} << kBlockShift;
+  const std::uint64_t blocks = (offsets.size() + block - 1) / block;
+
+  std::vector<std::uint64_t> bases(blocks);
+  std::vector<std::uint32_t> deltas(offsets.size());
+  for (std::uint64_t b = 0; b < blocks; ++b) {
+    bases[b] = offsets[b << kBlockShift];
+  }
+  for (std::uint64_t i = 0; i < offsets.size(); ++i) {
+    const std::uint64_t delta = offsets[i] - bases[i >> kBlockShift];
+    // A block of 2^16 records spanning more than 4 GiB (records
+    // averaging >64 KiB) cannot be delta-encoded in 32 bits; truncating
+    // would silently corrupt every lookup past this point.
+    if (delta > std::numeric_limits<std::uint32_t>::max()) {
+      throw std::runtime_error(idx_path +
+                               ": block span exceeds 32-bit deltas");
+    }
+    deltas[i] = static_cast<std::uint32_t>(delta);
+  }
+
+  std::FILE* f = std::fopen(idx_path.c_str(), "wb");
+  if (f == nullptr) throw_errno("open " + idx_path);
+  try {
+    Header h{kMagic, kVersion, kBlockShift, 0, record_count, offsets.back()};
+    write_all(f, &h, sizeof(h), idx_path);
+    write_all(f, bases.data(), bases.size() * sizeof(bases[0]), idx_path);
+    write_all(f, deltas.data(), deltas.size() * sizeof(deltas[0]), idx_path);
+  } catch (...) {
+    std::fclose(f);
+    throw;
+  }
+  if (std::fclose(f) != 0) throw_errno("close " + idx_path);
+}
+
+}  // namespace jsonl
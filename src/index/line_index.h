@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "io/mapped_reader.h"
+
+namespace jsonl {
+
+// Sidecar byte-offset index (`<log>.idx`) giving O(1) access from record
+// number to byte range in the JSONL file.
+//
+// Offsets are delta-compressed but still random-access: records are grouped
+// into fixed-size blocks (2^16 by default), each block stores its base
+// offset as a full 64-bit value and every record in the block stores a
+// 32-bit delta from that base. offset(i) is therefore one add and two
+// loads, and the index costs ~4 bytes per record instead of 8. A block's
+// records may span at most 4 GiB, comfortably above any real log section.
+//
+// On-disk layout (all little-endian, written by LineIndexBuilder):
+//   Header   { magic 'XILJ', version, block_shift, record_count, data_size }
+//   u64 base[ceil((record_count + 1) / block)]
+//   u32 delta[record_count + 1]        // entry record_count = data_size
+//
+// The trailing sentinel entry makes range(i) a plain offset(i+1) lookup.
+class LineIndex {
+ public:
+  struct Range {
+    std::uint64_t offset;
+    std::uint64_t length;  // includes the trailing '\n' if present
+  };
+
+  // Maps an existing index file. Throws std::system_error on I/O failure
+  // and std::runtime_error if the file is not a valid index.
+  explicit LineIndex(const std::string& idx_path);
+
+  std::uint64_t record_count() const noexcept { return record_count_; }
+
+  // Byte offset of the start of record `i`; i == record_count() yields the
+  // end of the data file.
+  std::uint64_t offset(std::uint64_t i) const noexcept {
+    return bases_[i >> block_shift_] + deltas_[i];
+  }
+
+  // Byte range of record `i`.
+  Range range(std::uint64_t i) const noexcept {
+    const std::uint64_t start = offset(i);
+    return {start, offset(i + 1) - start};
+  }
+
+  // Byte range covering records [first, last] inclusive — the shape replay
+  // tools ask for ("records 41,000,000-41,000,500").
+  Range range(std::uint64_t first, std::uint64_t last) const noexcept {
+    const std::uint64_t start = offset(first);
+    return {start, offset(last + 1) - start};
+  }
+
+ private:
+  MappedReader map_;
+  const std::uint64_t* bases_ = nullptr;
+  const std::uint32_t* deltas_ = nullptr;
+  std::uint64_t record_count_ = 0;
+  std::uint32_t block_shift_ = 0;
+};
+
+// Builds the sidecar index with one sequential pass over the JSONL file.
+class LineIndexBuilder {
+ public:
+  // Writes `idx_path` (conventionally `<jsonl_path>.idx`). Returns the
+  // number of records indexed. Throws std::system_error on I/O failure.
+  static std::uint64_t build(const std::string& jsonl_path,
+                             const std::string& idx_path);
+
+  // Serializes an already-collected offset list: one entry per record
+  // start plus a final end-of-data sentinel. Lets builders that scan the
+  // log for other sidecars (Bloom filters, zone maps) emit the offset
+  // index from the same pass. Throws std::runtime_error if a block of
+  // 2^16 records spans more than 4 GiB — the deltas would not fit the
+  // 32-bit encoding.
+  static void write(const std::string& idx_path,
+                    const std::vector<std::uint64_t>& offsets_with_sentinel);
+};
+
+}  // namespace jsonl
@@ -0,0 +1,160 @@
+#include "index/zone_map.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+#include "index/line_index.h"
+#include "parse/lazy_document.h"
+
+namespace jsonl {
+
+namespace {
+
+constexpr std::uint32_t kMagic = 0x4d5a4c4a;  // 'JLZM' on disk
+constexpr std::uint32_t kVersion = 1;
+constexpr std::size_t kNameBytes = 64;
+
+struct Header {
+  std::uint32_t magic;
+  std::uint32_t version;
+  std::uint64_t chunk_bytes;
+  std::uint32_t chunk_count;
+  std::uint32_t reserved;
+};
+static_assert(sizeof(Header) == 24);
+static_assert(sizeof(ZoneMapIndex::Zone) == 32);
+
+constexpr std::size_t kArenaBatch = 4096;
+
+}  // namespace
+
+ZoneMapIndex::ZoneMapIndex(const std::string& zm_path) : map_(zm_path) {
+  const std::string_view bytes = map_.data();
+  if (bytes.size() < sizeof(Header)) {
+    throw std::runtime_error(zm_path + ": not a zone map");
+  }
+  Header h;
+  std::memcpy(&h, bytes.data(), sizeof(h));
+  const std::uint64_t expect = sizeof(Header) + kNameBytes +
+                               std::uint64_t{h.chunk_count} * sizeof(Zone);
+  if (h.magic != kMagic || h.version != kVersion || bytes.size() < expect) {
+    throw std::runtime_error(zm_path + ": not a zone map");
+  }
+  chunk_bytes_ = h.chunk_bytes;
+  chunk_count_ = h.chunk_count;
+  const char* name = bytes.data() + sizeof(Header);
+  field_.assign(name, strnlen(name, kNameBytes));
+  zones_ = reinterpret_cast<const Zone*>(bytes.data() + sizeof(Header) +
+                                         kNameBytes);
+}
+
+bool ZoneMapIndex::may_overlap(std::uint32_t chunk, std::int64_t begin_ms,
+                               std::int64_t end_ms) const noexcept {
+  if (chunk >= chunk_count_) return false;
+  const Zone& z = zones_[chunk];
+  if (z.records == 0) return false;
+  if (z.missing != 0) return true;
+  return z.min_ts < end_ms && z.max_ts >= begin_ms;
+}
+
+std::function<bool(std::uint64_t, std::uint64_t)> ZoneMapIndex::chunk_predicate(
+    std::int64_t begin_ms, std::int64_t end_ms) const {
+  return [this, begin_ms, end_ms](std::uint64_t begin, std::uint64_t end) {
+    const std::uint32_t first = static_cast<std::uint32_t>(begin / chunk_bytes_);
+    const std::uint32_t last = end == begin
+                                   ? first
+                                   : static_cast<std::uint32_t>(
+                                         (end - 1) / chunk_bytes_);
+    for (std::uint32_t c = first; c <= last && c < chunk_count_; ++c) {
+      if (may_overlap(c, begin_ms, end_ms)) return true;
+    }
+    return false;
+  };
+}
+
+void ZoneMapIndexBuilder::build(const std::string& jsonl_path,
+                                const std::string& zm_path,
+                                const std::string& timestamp_field,
+                                const std::string& idx_path) {
+  build(jsonl_path, zm_path, timestamp_field, idx_path, Options());
+}
+
+void ZoneMapIndexBuilder::build(const std::string& jsonl_path,
+                                const std::string& zm_path,
+                                const std::string& timestamp_field,
+                                const std::string& idx_path,
+                                const Options& options) {
+  if (timestamp_field.size() >= kNameBytes) {
+    throw std::runtime_error("zone map field name too long: " +
+                             timestamp_field);
+  }
+
+  MappedReader reader(jsonl_path);
+  const std::string_view bytes = reader.data();
+  const std::uint32_t chunk_count = static_cast<std::uint32_t>(
+      (bytes.size() + options.chunk_bytes - 1) / options.chunk_bytes);
+
+  std::vector<ZoneMapIndex::Zone> zones(
+      chunk_count, {std::numeric_limits<std::int64_t>::max(),
+                    std::numeric_limits<std::int64_t>::min(), 0, 0});
+
+  std::vector<std::uint64_t> offsets;
+  const bool want_idx = !idx_path.empty();
+
+  Arena arena;
+  auto cursor = reader.lines();
+  std::string_view record;
+  std::uint64_t at = 0;
+  std::size_t n = 0;
+  while (true) {
+    const std::uint64_t start = at;
+    if (!cursor.next(record)) break;
+    at = cursor.offset();
+    if (want_idx) offsets.push_back(start);
+
+    ZoneMapIndex::Zone& z =
+        zones[static_cast<std::uint32_t>(start / options.chunk_bytes)];
+    ++z.records;
+
+    LazyDocument doc(record, arena);
+    const Value v = doc[timestamp_field];
+    const std::int64_t sentinel = std::numeric_limits<std::int64_t>::min();
+    const std::int64_t ts = v ? v.as_timestamp_ms(sentinel) : sentinel;
+    if (ts == sentinel) {
+      ++z.missing;
+    } else {
+      if (ts < z.min_ts) z.min_ts = ts;
+      if (ts > z.max_ts) z.max_ts = ts;
+    }
+    if (++n % kArenaBatch == 0) arena.reset();
+  }
+
+  std::FILE* f = std::fopen(zm_path.c_str(), "wb");
+  if (f == nullptr) {
+    throw std::system_error(errno, std::generic_category(), "open " + zm_path);
+  }
+  bool ok = true;
+  Header h{kMagic, kVersion, options.chunk_bytes, chunk_count, 0};
+  ok = ok && std::fwrite(&h, 1, sizeof(h), f) == sizeof(h);
+  char name[kNameBytes] = {};
+  std::memcpy(name, timestamp_field.data(), timestamp_field.size());
+  ok = ok && std::fwrite(name, 1, kNameBytes, f) == kNameBytes;
+  ok = ok && (zones.empty() ||
+              std::fwrite(zones.data(), 1, zones.size() * sizeof(zones[0]),
+                          f) == zones.size() * sizeof(zones[0]));
+  if (std::fclose(f) != 0 || !ok) {
+    throw std::system_error(EIO, std::generic_category(), "write " + zm_path);
+  }
+
+  if (want_idx) {
+    offsets.push_back(bytes.size());
+    LineIndexBuilder::write(idx_path, offsets);
+  }
+}
+
+}  // namespace jsonl
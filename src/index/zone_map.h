@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "io/mapped_reader.h"
+
+namespace jsonl {
+
+// Per-chunk timestamp zone maps for time-bounded scans (`<log>.zm` sidecar).
+//
+// The log is divided into fixed-size byte chunks (64 MiB by default) and
+// each chunk records the minimum and maximum timestamp of its records. Our
+// logs are roughly time-ordered, so the zones are narrow and nearly
+// disjoint: a "last 2 hours" query overlaps a handful of chunks at the tail
+// and skips the I/O and parsing for everything else. Records without a
+// parseable timestamp are counted per chunk, and a chunk containing any is
+// never pruned — zone maps must not make a query drop records the full
+// scan would have seen.
+//
+// The builder scans the log once and can emit the byte-offset line index
+// from the same pass, like BloomIndexBuilder.
+//
+// On-disk layout:
+//   Header { magic 'JLZM', version, chunk_bytes, chunk_count }
+//   timestamp field name, 64 bytes
+//   chunk_count x Zone { min_ts, max_ts, records, missing }
+class ZoneMapIndex {
+ public:
+  struct Zone {
+    std::int64_t min_ts;    // over records with a parseable timestamp
+    std::int64_t max_ts;
+    std::uint64_t records;  // total records starting in the chunk
+    std::uint64_t missing;  // of which had no parseable timestamp
+  };
+
+  explicit ZoneMapIndex(const std::string& zm_path);
+
+  std::uint64_t chunk_bytes() const noexcept { return chunk_bytes_; }
+  std::uint32_t chunk_count() const noexcept { return chunk_count_; }
+  const std::string& timestamp_field() const noexcept { return field_; }
+  const Zone& zone(std::uint32_t chunk) const noexcept {
+    return zones_[chunk];
+  }
+
+  // Whether any record in the chunk may fall inside the half-open
+  // epoch-millisecond range [begin_ms, end_ms). Chunks with untimestamped
+  // records always may; empty chunks never do.
+  bool may_overlap(std::uint32_t chunk, std::int64_t begin_ms,
+                   std::int64_t end_ms) const noexcept;
+
+  // Predicate over byte ranges for ParallelScanner::scan(): true when any
+  // overlapped chunk may hold records in the time range.
+  std::function<bool(std::uint64_t, std::uint64_t)> chunk_predicate(
+      std::int64_t begin_ms, std::int64_t end_ms) const;
+
+ private:
+  MappedReader map_;
+  std::uint64_t chunk_bytes_ = 0;
+  std::uint32_t chunk_count_ = 0;
+  std::string field_;
+  const Zone* zones_ = nullptr;
+};
+
+class ZoneMapIndexBuilder {
+ public:
+  struct Options {
+    std::uint64_t chunk_bytes = 64ull << 20;
+  };
+
+  // One pass over `jsonl_path` writing `zm_path`, reading timestamps from
+  // `timestamp_field` (numeric epoch milliseconds or ISO-8601 strings). If
+  // `idx_path` is non-empty the byte-offset line index is written from the
+  // same pass.
+  static void build(const std::string& jsonl_path, const std::string& zm_path,
+                    const std::string& timestamp_field,
+                    const std::string& idx_path, const Options& options);
+  static void build(const std::string& jsonl_path, const std::string& zm_path,
+                    const std::string& timestamp_field = "timestamp",
+                    const std::string& idx_path = {});
+};
+
+}  // namespace jsonl
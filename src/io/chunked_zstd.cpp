@@ -0,0 +1,178 @@
+#include "io/chunked_zstd.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#include "perf/trace.h"
+
+#if WORK_SAMPLES_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace jsonl {
+
+namespace {
+
+constexpr std::uint32_t kMagic = 0x315a4c4a;  // 'JLZ1' on disk
+
+struct Trailer {
+  std::uint64_t footer_offset;
+  std::uint32_t frame_count;
+  std::uint32_t magic;
+};
+static_assert(sizeof(Trailer) == 16);
+static_assert(sizeof(FrameInfo) == 48);
+
+[[noreturn]] void no_codec() {
+  throw std::runtime_error(
+      "work_samples was built without libzstd; rebuild with zstd installed");
+}
+
+#if WORK_SAMPLES_HAVE_ZSTD
+[[noreturn]] void throw_errno(const std::string& what) {
+  throw std::system_error(errno, std::generic_category(), what);
+}
+
+void write_all(std::FILE* f, const void* p, std::size_t n,
+               const std::string& path) {
+  if (n != 0 && std::fwrite(p, 1, n, f) != n) throw_errno("write " + path);
+}
+#endif
+
+}  // namespace
+
+bool ChunkedZstdReader::codec_available() noexcept {
+#if WORK_SAMPLES_HAVE_ZSTD
+  return true;
+#else
+  return false;
+#endif
+}
+
+void ChunkedZstdWriter::compress_file(const std::string& jsonl_path,
+                                      const std::string& out_path,
+                                      const ChunkedZstdOptions& options) {
+#if !WORK_SAMPLES_HAVE_ZSTD
+  (void)jsonl_path;
+  (void)out_path;
+  (void)options;
+  no_codec();
+#else
+  MappedReader reader(jsonl_path);
+  const std::string_view bytes = reader.data();
+
+  std::FILE* f = std::fopen(out_path.c_str(), "wb");
+  if (f == nullptr) throw_errno("open " + out_path);
+
+  std::vector<FrameInfo> frames;
+  std::vector<char> scratch;
+  try {
+    std::uint64_t raw_at = 0;
+    std::uint64_t compressed_at = 0;
+    std::uint64_t record_at = 0;
+
+    while (raw_at < bytes.size()) {
+      // Frame spans to the first newline at or after the size target; the
+      // final frame may end without one.
+      std::uint64_t raw_end =
+          std::min<std::uint64_t>(raw_at + options.frame_raw_bytes,
+                                  bytes.size());
+      if (raw_end < bytes.size()) {
+        const char* nl = static_cast<const char*>(std::memchr(
+            bytes.data() + raw_end, '\n', bytes.size() - raw_end));
+        raw_end = nl != nullptr
+                      ? static_cast<std::uint64_t>(nl - bytes.data()) + 1
+                      : bytes.size();
+      }
+      const std::string_view span = bytes.substr(raw_at, raw_end - raw_at);
+      std::uint64_t records = static_cast<std::uint64_t>(
+          std::count(span.begin(), span.end(), '\n'));
+      if (!span.empty() && span.back() != '\n') ++records;
+
+      scratch.resize(ZSTD_compressBound(span.size()));
+      const std::size_t csize =
+          ZSTD_compress(scratch.data(), scratch.size(), span.data(),
+                        span.size(), options.level);
+      if (ZSTD_isError(csize)) {
+        throw std::runtime_error(std::string("zstd compress: ") +
+                                 ZSTD_getErrorName(csize));
+      }
+      write_all(f, scratch.data(), csize, out_path);
+
+      frames.push_back(FrameInfo{compressed_at, csize, raw_at, span.size(),
+                                 record_at, records});
+      compressed_at += csize;
+      raw_at = raw_end;
+      record_at += records;
+    }
+
+    write_all(f, frames.data(), frames.size() * sizeof(FrameInfo), out_path);
+    Trailer t{compressed_at, static_cast<std::uint32_t>(frames.size()),
+              kMagic};
+    write_all(f, &t, sizeof(t), out_path);
+  } catch (...) {
+    std::fclose(f);
+    throw;
+  }
+  if (std::fclose(f) != 0) throw_errno("close " + out_path);
+#endif
+}
+
+ChunkedZstdReader::ChunkedZstdReader(const std::string& path) : map_(path) {
+  const std::string_view bytes = map_.data();
+  if (bytes.size() < sizeof(Trailer)) {
+    throw std::runtime_error(path + ": not a chunked zstd container");
+  }
+  Trailer t;
+  std::memcpy(&t, bytes.data() + bytes.size() - sizeof(Trailer), sizeof(t));
+  const std::uint64_t footer_size =
+      std::uint64_t{t.frame_count} * sizeof(FrameInfo);
+  if (t.magic != kMagic ||
+      t.footer_offset + footer_size + sizeof(Trailer) != bytes.size()) {
+    throw std::runtime_error(path + ": not a chunked zstd container");
+  }
+  frames_.resize(t.frame_count);
+  std::memcpy(frames_.data(), bytes.data() + t.footer_offset, footer_size);
+  if (!frames_.empty()) {
+    const FrameInfo& last = frames_.back();
+    record_count_ = last.first_record + last.record_count;
+    raw_size_ = last.raw_offset + last.raw_size;
+  }
+}
+
+std::size_t ChunkedZstdReader::frame_for_record(
+    std::uint64_t record) const noexcept {
+  auto it = std::upper_bound(
+      frames_.begin(), frames_.end(), record,
+      [](std::uint64_t r, const FrameInfo& f) { return r < f.first_record; });
+  return it == frames_.begin() ? 0 : (it - frames_.begin()) - 1;
+}
+
+std::size_t ChunkedZstdReader::decompress_frame(std::size_t i, char* dst,
+                                                std::size_t capacity) const {
+#if !WORK_SAMPLES_HAVE_ZSTD
+  (void)i;
+  (void)dst;
+  (void)capacity;
+  no_codec();
+#else
+  perf::TraceSpan span("zstd_decompress");
+  const FrameInfo& frame = frames_.at(i);
+  if (capacity < frame.raw_size) {
+    throw std::runtime_error("decompress_frame: buffer too small");
+  }
+  const std::size_t n = ZSTD_decompress(
+      dst, capacity, map_.data().data() + frame.compressed_offset,
+      frame.compressed_size);
+  if (ZSTD_isError(n) || n != frame.raw_size) {
+    throw std::runtime_error("decompress_frame: corrupt frame");
+  }
+  return n;
+#endif
+}
+
+}  // namespace jsonl
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "io/mapped_reader.h"
+
+namespace jsonl {
+
+// Chunked zstd container for JSONL logs (`.jlz`).
+//
+// A plain `.zst` stream compresses well but forces single-threaded
+// decompression and kills random access. This container instead compresses
+// the log as a sequence of independent zstd frames, each covering a
+// newline-aligned span of records, and appends a footer listing every
+// frame's compressed offset, raw offset/size and first record number.
+// Frames decompress in parallel across cores (ParallelScanner has a
+// scan() overload for this reader) and record-number random access costs
+// one frame decompression via the footer table.
+//
+// On-disk layout:
+//   frame 0 | frame 1 | ... | FrameEntry[frame_count] | Trailer
+// where Trailer = { u64 footer_offset, u32 frame_count, u32 magic 'JLZ1' }
+// sits in the last 16 bytes so readers find the footer from the end.
+//
+// Compression and decompression require libzstd; builds without it can
+// still open containers and read the frame table, but codec calls throw.
+
+struct FrameInfo {
+  std::uint64_t compressed_offset;
+  std::uint64_t compressed_size;
+  std::uint64_t raw_offset;  // byte offset in the uncompressed log
+  std::uint64_t raw_size;
+  std::uint64_t first_record;
+  std::uint64_t record_count;
+};
+
+struct ChunkedZstdOptions {
+  // Raw bytes per frame before newline alignment. Larger frames compress
+  // better; smaller frames parallelize and seek better. 4 MiB is a good
+  // middle for 200-300 byte records.
+  std::size_t frame_raw_bytes = 4 << 20;
+  int level = 3;
+};
+
+class ChunkedZstdWriter {
+ public:
+  // Compresses `jsonl_path` into `out_path`. Throws std::runtime_error if
+  // built without zstd, std::system_error on I/O failure.
+  static void compress_file(const std::string& jsonl_path,
+                            const std::string& out_path,
+                            const ChunkedZstdOptions& options = {});
+};
+
+class ChunkedZstdReader {
+ public:
+  // Maps the container and parses the footer; works without libzstd.
+  explicit ChunkedZstdReader(const std::string& path);
+
+  const std::vector<FrameInfo>& frames() const noexcept { return frames_; }
+  std::uint64_t record_count() const noexcept { return record_count_; }
+  std::uint64_t raw_size() const noexcept { return raw_size_; }
+
+  // Index of the frame containing record number `record` (binary search
+  // over the footer table).
+  std::size_t frame_for_record(std::uint64_t record) const noexcept;
+
+  // Decompresses frame `i` into `dst` (capacity must be at least
+  // frames()[i].raw_size). Returns the raw size. Throws if built without
+  // zstd or on corrupt data.
+  std::size_t decompress_frame(std::size_t i, char* dst,
+                               std::size_t capacity) const;
+
+  // True when libzstd was compiled in.
+  static bool codec_available() noexcept;
+
+ private:
+  MappedReader map_;
+  std::vector<FrameInfo> frames_;
+  std::uint64_t record_count_ = 0;
+  std::uint64_t raw_size_ = 0;
+};
+
+}  // namespace jsonl
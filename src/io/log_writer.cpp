@@ -0,0 +1,269 @@
+#include "io/log_writer.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#include "mem/buffer_pool.h"
+#include "perf/scan_stats.h"
+
+namespace jsonl {
+
+namespace {
+
+constexpr std::size_t kLenBytes = sizeof(std::uint32_t);
+
+std::size_t round_up_pow2(std::size_t n) noexcept {
+  std::size_t p = 1;
+  while (p < n) p <<= 1;
+  return p;
+}
+
+}  // namespace
+
+// Single-producer single-consumer byte ring. The producer owns tail_, the
+// writer thread owns head_; each side only stores its own index (release)
+// and loads the other's (acquire). Records are framed as u32 length + bytes
+// and may wrap around the ring edge.
+class alignas(64) LogWriter::Ring {
+ public:
+  explicit Ring(std::size_t capacity)
+      : capacity_(round_up_pow2(capacity)), mask_(capacity_ - 1) {
+    buf_ = static_cast<char*>(
+        BufferPool::instance().acquire(capacity_, buf_bytes_));
+  }
+  ~Ring() { BufferPool::instance().release(buf_, buf_bytes_); }
+
+  Ring(const Ring&) = delete;
+  Ring& operator=(const Ring&) = delete;
+
+  std::size_t capacity() const noexcept { return capacity_; }
+
+  bool try_push(std::string_view record) noexcept {
+    const std::size_t need = kLenBytes + record.size();
+    const std::size_t head = head_.load(std::memory_order_acquire);
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    if (capacity_ - (tail - head) < need) return false;
+
+    const std::uint32_t len = static_cast<std::uint32_t>(record.size());
+    copy_in(tail, &len, kLenBytes);
+    copy_in(tail + kLenBytes, record.data(), record.size());
+    tail_.store(tail + need, std::memory_order_release);
+    return true;
+  }
+
+  // Writer side: appends every complete record currently in the ring to
+  // `out` (with trailing newlines) and advances head. Returns records
+  // drained.
+  std::size_t drain(std::vector<char>& out) noexcept {
+    std::size_t head = head_.load(std::memory_order_relaxed);
+    const std::size_t tail = tail_.load(std::memory_order_acquire);
+    std::size_t drained = 0;
+    while (head != tail) {
+      std::uint32_t len;
+      copy_out(head, &len, kLenBytes);
+      const std::size_t at = out.size();
+      out.resize(at + len + 1);
+      copy_out(head + kLenBytes, out.data() + at, len);
+      out[at + len] = '\n';
+      head += kLenBytes + len;
+      ++drained;
+    }
+    head_.store(head, std::memory_order_release);
+    return drained;
+  }
+
+ private:
+  void copy_in(std::size_t pos, const void* src, std::size_t n) noexcept {
+    const std::size_t at = pos & mask_;
+    const std::size_t first = std::min(n, capacity_ - at);
+    std::memcpy(buf_ + at, src, first);
+    std::memcpy(buf_, static_cast<const char*>(src) + first, n - first);
+  }
+  void copy_out(std::size_t pos, void* dst, std::size_t n) noexcept {
+    const std::size_t at = pos & mask_;
+    const std::size_t first = std::min(n, capacity_ - at);
+    std::memcpy(dst, buf_ + at, first);
+    std::memcpy(static_cast<char*>(dst) + first, buf_, n - first);
+  }
+
+  const std::size_t capacity_;
+  const std::size_t mask_;
+  char* buf_ = nullptr;  // pool-backed
+  std::size_t buf_bytes_ = 0;
+  alignas(64) std::atomic<std::size_t> head_{0};
+  alignas(64) std::atomic<std::size_t> tail_{0};
+};
+
+LogWriter::LogWriter(const std::string& path) : LogWriter(path, Options()) {}
+
+namespace {
+
+// Process-unique writer ids for the per-thread ring cache: a raw
+// LogWriter* can be reused by a later writer at the same address (log
+// rotation does exactly this), so cache hits validate the id too.
+std::atomic<std::uint64_t> g_next_writer_id{1};
+
+}  // namespace
+
+LogWriter::LogWriter(const std::string& path, const Options& options)
+    : opt_(options),
+      id_(g_next_writer_id.fetch_add(1, std::memory_order_relaxed)),
+      last_sync_(std::chrono::steady_clock::now()) {
+  fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+  if (fd_ < 0) {
+    throw std::system_error(errno, std::generic_category(), "open " + path);
+  }
+  batch_.reserve(opt_.batch_bytes);
+  writer_ = std::thread(&LogWriter::writer_main, this);
+}
+
+LogWriter::~LogWriter() {
+  stop_.store(true, std::memory_order_release);
+  writer_.join();
+  ::close(fd_);
+}
+
+LogWriter::Ring* LogWriter::ring_for_this_thread() {
+  // One slot per (writer, thread) pair; entries only accumulate, and
+  // lookups after registration are a thread_local hit. Matching on the
+  // pointer alone would resurrect a dead writer's ring when a new writer
+  // lands at the same address, so the id is part of the key; stale
+  // entries for destroyed writers just never match again.
+  struct CacheEntry {
+    LogWriter* writer;
+    std::uint64_t id;
+    Ring* ring;
+  };
+  thread_local std::vector<CacheEntry> cache;
+  for (const CacheEntry& e : cache) {
+    if (e.writer == this && e.id == id_) return e.ring;
+  }
+  std::lock_guard<std::mutex> lock(rings_mutex_);
+  rings_.push_back(std::make_unique<Ring>(opt_.ring_bytes));
+  Ring* ring = rings_.back().get();
+  ring_count_.store(rings_.size(), std::memory_order_release);
+  cache.push_back({this, id_, ring});
+  return ring;
+}
+
+void LogWriter::append(std::string_view record) {
+  Ring* ring = ring_for_this_thread();
+  if (kLenBytes + record.size() > ring->capacity()) {
+    // try_push can never succeed, even against an empty ring; waiting
+    // would spin forever.
+    throw std::invalid_argument("LogWriter::append: record larger than ring");
+  }
+  while (!ring->try_push(record)) {
+    // Ring full: the writer thread is behind. Yield rather than spin hot;
+    // latency stays bounded by one batch drain.
+    perf::counters().ring_full_waits.fetch_add(1, std::memory_order_relaxed);
+    std::this_thread::yield();
+  }
+  records_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LogWriter::flush() {
+  const std::uint64_t ticket =
+      flush_wanted_.fetch_add(1, std::memory_order_acq_rel) + 1;
+  std::unique_lock<std::mutex> lock(flush_mutex_);
+  flush_cv_.wait(lock, [&] { return flush_done_ >= ticket; });
+}
+
+std::size_t LogWriter::drain_rings() {
+  // rings_ may reallocate under a concurrent registration, so the writer
+  // never touches it lock-free; it drains its own stable mirror and tops
+  // the mirror up under the mutex only when the count says it is behind.
+  if (ring_count_.load(std::memory_order_acquire) > writer_rings_.size()) {
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    while (writer_rings_.size() < rings_.size()) {
+      writer_rings_.push_back(rings_[writer_rings_.size()].get());
+    }
+  }
+  std::size_t drained = 0;
+  for (Ring* ring : writer_rings_) drained += ring->drain(batch_);
+  return drained;
+}
+
+void LogWriter::commit(bool force_sync) {
+  if (!batch_.empty()) {
+    const char* p = batch_.data();
+    std::size_t left = batch_.size();
+    while (left > 0) {
+      ssize_t n = ::write(fd_, p, left);
+      if (n < 0) {
+        if (errno == EINTR) continue;
+        throw std::system_error(errno, std::generic_category(),
+                                "write log batch");
+      }
+      p += n;
+      left -= static_cast<std::size_t>(n);
+    }
+    bytes_.fetch_add(batch_.size(), std::memory_order_relaxed);
+    batches_.fetch_add(1, std::memory_order_relaxed);
+    perf::counters().bytes_written.fetch_add(batch_.size(),
+                                             std::memory_order_relaxed);
+    batch_.clear();
+  }
+
+  bool sync = force_sync && opt_.fsync != FsyncPolicy::kNever;
+  if (opt_.fsync == FsyncPolicy::kEveryBatch) sync = true;
+  if (opt_.fsync == FsyncPolicy::kInterval) {
+    const auto now = std::chrono::steady_clock::now();
+    if (now - last_sync_ >= opt_.fsync_interval) sync = true;
+  }
+  if (sync) {
+    ::fdatasync(fd_);
+    last_sync_ = std::chrono::steady_clock::now();
+    syncs_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void LogWriter::writer_main() {
+  while (true) {
+    const bool stopping = stop_.load(std::memory_order_acquire);
+    const std::uint64_t flush_goal =
+        flush_wanted_.load(std::memory_order_acquire);
+
+    const std::size_t drained = drain_rings();
+
+    const bool flush_pending = flush_goal > flush_done_;
+    if (batch_.size() >= opt_.batch_bytes || flush_pending || stopping) {
+      commit(/*force_sync=*/flush_pending || stopping);
+      if (flush_pending) {
+        std::lock_guard<std::mutex> lock(flush_mutex_);
+        flush_done_ = flush_goal;
+        flush_cv_.notify_all();
+      }
+    }
+
+    if (stopping && drained == 0 && batch_.empty()) {
+      // One final sweep: a producer may have pushed between the drain and
+      // the stop check.
+      if (drain_rings() == 0) break;
+      continue;
+    }
+    if (drained == 0 && !stopping) {
+      // Idle: write out whatever trickled in, then nap briefly. 100us keeps
+      // worst-case append-to-disk latency low without burning a core.
+      commit(/*force_sync=*/false);
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+  }
+  commit(/*force_sync=*/true);
+}
+
+LogWriter::Stats LogWriter::stats() const noexcept {
+  Stats s;
+  s.records = records_.load(std::memory_order_relaxed);
+  s.bytes = bytes_.load(std::memory_order_relaxed);
+  s.batches = batches_.load(std::memory_order_relaxed);
+  s.syncs = syncs_.load(std::memory_order_relaxed);
+  return s;
+}
+
+}  // namespace jsonl
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace jsonl {
+
+// Multi-producer JSONL ingestion writer with group commit.
+//
+// Each producer thread gets its own lock-free SPSC byte ring on first
+// append, so the hot path is a length-prefixed copy plus a release store —
+// no shared mutex, no syscall, and bounded latency (a producer only waits
+// when its own ring is full, i.e. under sustained overload). A single
+// writer thread drains all rings, concatenates records into large batches
+// and commits them with one write() per batch; fsync behaviour is
+// configurable per deployment (never / interval / every batch).
+//
+// Records are appended verbatim with a trailing '\n'; callers pass one
+// JSON object per append() and must not include the newline themselves.
+class LogWriter {
+ public:
+  enum class FsyncPolicy {
+    kNever,     // leave durability to the kernel
+    kInterval,  // fdatasync at most once per fsync_interval
+    kEveryBatch,
+  };
+
+  struct Options {
+    std::size_t ring_bytes = 1 << 20;   // per-producer ring capacity
+    std::size_t batch_bytes = 4 << 20;  // target bytes per write()
+    FsyncPolicy fsync = FsyncPolicy::kNever;
+    std::chrono::milliseconds fsync_interval{1000};
+  };
+
+  // Opens `path` for appending (created if absent) and starts the writer
+  // thread. Throws std::system_error on open failure.
+  explicit LogWriter(const std::string& path);
+  LogWriter(const std::string& path, const Options& options);
+  ~LogWriter();  // drains, syncs per policy, joins the writer thread
+
+  LogWriter(const LogWriter&) = delete;
+  LogWriter& operator=(const LogWriter&) = delete;
+
+  // Queues one record. Waits (spinning with yields) only when the calling
+  // thread's ring is full. Throws std::invalid_argument for a record that
+  // cannot fit an empty ring — it could never drain, so waiting would
+  // hang the producer forever.
+  void append(std::string_view record);
+
+  // Blocks until everything appended before the call is written, and
+  // synced if the policy ever syncs.
+  void flush();
+
+  struct Stats {
+    std::uint64_t records = 0;
+    std::uint64_t bytes = 0;
+    std::uint64_t batches = 0;
+    std::uint64_t syncs = 0;
+  };
+  Stats stats() const noexcept;
+
+ private:
+  class Ring;
+
+  Ring* ring_for_this_thread();
+  void writer_main();
+  // Drains every ring into batch_; returns bytes collected.
+  std::size_t drain_rings();
+  void commit(bool force_sync);
+
+  int fd_ = -1;
+  Options opt_;
+  std::uint64_t id_ = 0;  // process-unique, never reused (see cpp)
+
+  std::mutex rings_mutex_;  // guards registration only
+  std::vector<std::unique_ptr<Ring>> rings_;
+  std::atomic<std::size_t> ring_count_{0};
+  std::vector<Ring*> writer_rings_;  // writer-thread-private mirror
+
+  std::thread writer_;
+  std::atomic<bool> stop_{false};
+
+  std::mutex flush_mutex_;
+  std::condition_variable flush_cv_;
+  std::atomic<std::uint64_t> flush_wanted_{0};  // flush() tickets
+  std::uint64_t flush_done_ = 0;                // writer-side progress
+
+  std::vector<char> batch_;
+  std::chrono::steady_clock::time_point last_sync_;
+
+  std::atomic<std::uint64_t> records_{0};
+  std::atomic<std::uint64_t> bytes_{0};
+  std::atomic<std::uint64_t> batches_{0};
+  std::atomic<std::uint64_t> syncs_{0};
+};
+
+}  // namespace jsonl
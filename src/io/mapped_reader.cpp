@@ -0,0 +1,91 @@
+#include "io/mapped_reader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+#include <utility>
+
+namespace jsonl {
+
+namespace {
+
+[[noreturn]] void throw_errno(const std::string& what) {
+  throw std::system_error(errno, std::generic_category(), what);
+}
+
+}  // namespace
+
+MappedReader::MappedReader(const std::string& path) {
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) throw_errno("open " + path);
+
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    int saved = errno;
+    ::close(fd);
+    errno = saved;
+    throw_errno("fstat " + path);
+  }
+  size_ = static_cast<std::size_t>(st.st_size);
+
+  if (size_ > 0) {
+    void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED) {
+      int saved = errno;
+      ::close(fd);
+      errno = saved;
+      throw_errno("mmap " + path);
+    }
+    base_ = static_cast<const char*>(p);
+    // Best effort: the kernel will read ahead aggressively and drop pages
+    // behind the scan instead of letting a 240 GB pass evict everything.
+    ::madvise(const_cast<char*>(base_), size_, MADV_SEQUENTIAL);
+  }
+  // The mapping keeps its own reference to the file.
+  ::close(fd);
+}
+
+MappedReader::~MappedReader() { reset(); }
+
+MappedReader::MappedReader(MappedReader&& other) noexcept
+    : base_(std::exchange(other.base_, nullptr)),
+      size_(std::exchange(other.size_, 0)) {}
+
+MappedReader& MappedReader::operator=(MappedReader&& other) noexcept {
+  if (this != &other) {
+    reset();
+    base_ = std::exchange(other.base_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+  }
+  return *this;
+}
+
+void MappedReader::reset() noexcept {
+  if (base_ != nullptr) {
+    ::munmap(const_cast<char*>(base_), size_);
+    base_ = nullptr;
+    size_ = 0;
+  }
+}
+
+bool MappedReader::LineCursor::next(std::string_view& out) noexcept {
+  if (pos_ >= bytes_.size()) return false;
+  const char* start = bytes_.data() + pos_;
+  std::size_t remaining = bytes_.size() - pos_;
+  const char* nl = static_cast<const char*>(std::memchr(start, '\n', remaining));
+  if (nl == nullptr) {
+    out = {start, remaining};
+    pos_ = bytes_.size();
+  } else {
+    out = {start, static_cast<std::size_t>(nl - start)};
+    pos_ += out.size() + 1;
+  }
+  return true;
+}
+
+}  // namespace jsonl
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace jsonl {
+
+// Zero-copy reader for a JSONL file such as requests.jsonl.
+//
+// The whole file is memory-mapped read-only and records are handed out as
+// std::string_view slices into the mapping, so a full scan performs no
+// per-record copies or allocations. The mapping is advised for sequential
+// access (MADV_SEQUENTIAL) since the dominant workload is a front-to-back
+// scan of a multi-hundred-gigabyte log.
+//
+// Views returned by next_line() / LineRange stay valid for the lifetime of
+// the MappedReader.
+class MappedReader {
+ public:
+  // Maps `path`. Throws std::system_error if the file cannot be opened,
+  // stat'ed, or mapped.
+  explicit MappedReader(const std::string& path);
+  ~MappedReader();
+
+  MappedReader(const MappedReader&) = delete;
+  MappedReader& operator=(const MappedReader&) = delete;
+  MappedReader(MappedReader&& other) noexcept;
+  MappedReader& operator=(MappedReader&& other) noexcept;
+
+  // The entire mapped file.
+  std::string_view data() const noexcept { return {base_, size_}; }
+  std::size_t size() const noexcept { return size_; }
+
+  // Sequential line cursor over a mapped byte range. Lines exclude the
+  // trailing '\n'; a final unterminated line is still delivered.
+  class LineCursor {
+   public:
+    explicit LineCursor(std::string_view bytes) noexcept
+        : bytes_(bytes), pos_(0) {}
+
+    // Yields the next line into `out`. Returns false at end of input.
+    bool next(std::string_view& out) noexcept;
+
+    // Byte offset of the start of the next line to be yielded.
+    std::size_t offset() const noexcept { return pos_; }
+
+   private:
+    std::string_view bytes_;
+    std::size_t pos_;
+  };
+
+  // Cursor over the whole file.
+  LineCursor lines() const noexcept { return LineCursor(data()); }
+
+  // Cursor over [offset, offset + length); callers are expected to pass
+  // line-aligned ranges (e.g. from a line index).
+  LineCursor lines_at(std::size_t offset, std::size_t length) const noexcept {
+    return LineCursor(data().substr(offset, length));
+  }
+
+ private:
+  void reset() noexcept;
+
+  const char* base_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+}  // namespace jsonl
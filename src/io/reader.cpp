@@ -0,0 +1,47 @@
+#include "io/reader.h"
+
+#include <stdexcept>
+
+#include "io/mapped_reader.h"
+#include "io/uring_reader.h"
+
+namespace jsonl {
+
+namespace {
+
+// Mmap backend behind the Reader interface: a MappedReader plus its line
+// cursor. Views point into the mapping and in fact outlive the next()
+// contract, but callers should not rely on that through this interface.
+class MappedLineReader final : public Reader {
+ public:
+  explicit MappedLineReader(const std::string& path)
+      : map_(path), cursor_(map_.lines()) {}
+
+  bool next(std::string_view& record) override { return cursor_.next(record); }
+
+  std::uint64_t offset() const noexcept override { return cursor_.offset(); }
+
+ private:
+  MappedReader map_;
+  MappedReader::LineCursor cursor_;
+};
+
+}  // namespace
+
+std::unique_ptr<Reader> open_reader(const std::string& path,
+                                    const ReaderOptions& options) {
+  switch (options.backend) {
+    case ReaderBackend::kMmap:
+      return std::make_unique<MappedLineReader>(path);
+    case ReaderBackend::kUring:
+      return std::make_unique<UringReader>(path);
+    case ReaderBackend::kAuto:
+      break;
+  }
+  if (UringReader::supported()) {
+    return std::make_unique<UringReader>(path);
+  }
+  return std::make_unique<MappedLineReader>(path);
+}
+
+}  // namespace jsonl
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace jsonl {
+
+// Sequential record source abstracting the I/O backend.
+//
+// MappedReader remains the right tool for warm scans and random access;
+// this interface exists so cold-scan consumers can swap in the io_uring
+// prefetch backend (or future backends) without touching their loop.
+//
+// Contract: next() yields records in file order without the trailing
+// newline. The returned view stays valid only until the following next()
+// call — backends that recycle buffers invalidate earlier views. Callers
+// needing longer lifetimes copy.
+class Reader {
+ public:
+  virtual ~Reader() = default;
+
+  virtual bool next(std::string_view& record) = 0;
+
+  // Byte offset of the first record not yet returned.
+  virtual std::uint64_t offset() const noexcept = 0;
+};
+
+enum class ReaderBackend {
+  kAuto,   // io_uring when the kernel supports it, else mmap
+  kMmap,
+  kUring,
+};
+
+struct ReaderOptions {
+  ReaderBackend backend = ReaderBackend::kAuto;
+};
+
+// Opens `path` with the selected backend. Throws std::system_error if the
+// file cannot be opened, or std::runtime_error if kUring is requested on a
+// kernel/build without io_uring support.
+std::unique_ptr<Reader> open_reader(const std::string& path,
+                                    const ReaderOptions& options = {});
+
+}  // namespace jsonl
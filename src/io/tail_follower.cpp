@@ -0,0 +1,192 @@
+#include "io/tail_follower.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <system_error>
+
+namespace jsonl {
+
+namespace {
+
+constexpr std::uint32_t kCkptMagic = 0x54504b43;  // 'CKPT' on disk
+
+struct CheckpointFile {
+  std::uint32_t magic;
+  std::uint32_t reserved;
+  std::uint64_t dev;
+  std::uint64_t inode;
+  std::uint64_t offset;
+  std::uint64_t records;
+};
+static_assert(sizeof(CheckpointFile) == 40);
+
+[[noreturn]] void throw_errno(const std::string& what) {
+  throw std::system_error(errno, std::generic_category(), what);
+}
+
+}  // namespace
+
+TailFollower::TailFollower(const std::string& path)
+    : TailFollower(path, Options()) {}
+
+TailFollower::TailFollower(const std::string& path, const Options& options)
+    : path_(path), opt_(options) {
+  if (opt_.checkpoint_path.empty()) opt_.checkpoint_path = path_ + ".ckpt";
+  buf_.resize(1 << 20);
+
+  reopen();
+  load_checkpoint();
+
+  inotify_fd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (inotify_fd_ >= 0) {
+    watch_ = ::inotify_add_watch(inotify_fd_, path_.c_str(),
+                                 IN_MODIFY | IN_MOVE_SELF | IN_DELETE_SELF);
+  }
+}
+
+TailFollower::~TailFollower() {
+  if (inotify_fd_ >= 0) ::close(inotify_fd_);
+  if (fd_ >= 0) ::close(fd_);
+}
+
+bool TailFollower::reopen() {
+  int fd = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) throw_errno("open " + path_);
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    int err = errno;
+    ::close(fd);
+    errno = err;
+    throw_errno("fstat " + path_);
+  }
+  const bool changed = st.st_dev != dev_ || st.st_ino != inode_;
+  if (fd_ >= 0) ::close(fd_);
+  fd_ = fd;
+  dev_ = st.st_dev;
+  inode_ = st.st_ino;
+  return changed;
+}
+
+void TailFollower::load_checkpoint() {
+  std::FILE* f = std::fopen(opt_.checkpoint_path.c_str(), "rb");
+  if (f == nullptr) return;  // no checkpoint yet: start from byte zero
+  CheckpointFile c;
+  const bool ok = std::fread(&c, 1, sizeof(c), f) == sizeof(c);
+  std::fclose(f);
+  if (!ok || c.magic != kCkptMagic) return;
+  // A checkpoint for a different file (rotation) is ignored, not an error.
+  if (c.dev != dev_ || c.inode != inode_) return;
+  offset_ = c.offset;
+  records_ = c.records;
+}
+
+void TailFollower::checkpoint() const {
+  const std::string tmp = opt_.checkpoint_path + ".tmp";
+  std::FILE* f = std::fopen(tmp.c_str(), "wb");
+  if (f == nullptr) throw_errno("open " + tmp);
+  CheckpointFile c{kCkptMagic, 0, dev_, inode_, offset_, records_};
+  const bool ok = std::fwrite(&c, 1, sizeof(c), f) == sizeof(c);
+  if (std::fclose(f) != 0 || !ok) throw_errno("write " + tmp);
+  if (std::rename(tmp.c_str(), opt_.checkpoint_path.c_str()) != 0) {
+    throw_errno("rename " + tmp);
+  }
+}
+
+std::uint64_t TailFollower::poll(const RecordFn& fn) {
+  std::uint64_t delivered = 0;
+  while (true) {
+    const ssize_t n =
+        ::pread(fd_, buf_.data(), buf_.size(), static_cast<off_t>(offset_));
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      throw_errno("pread " + path_);
+    }
+    if (n == 0) break;
+
+    // Deliver complete lines only; a torn tail waits for its newline.
+    std::size_t consumed = 0;
+    while (true) {
+      const char* start = buf_.data() + consumed;
+      const char* nl = static_cast<const char*>(
+          std::memchr(start, '\n', n - consumed));
+      if (nl == nullptr) break;
+      const std::size_t len = static_cast<std::size_t>(nl - start);
+      fn(std::string_view(start, len), offset_ + consumed, records_);
+      ++records_;
+      ++delivered;
+      consumed += len + 1;
+    }
+    if (consumed == 0) {
+      // A record longer than the buffer: grow and retry, otherwise we
+      // could never make progress past it.
+      if (static_cast<std::size_t>(n) == buf_.size()) {
+        buf_.resize(buf_.size() * 2);
+        continue;
+      }
+      break;  // only a partial record available
+    }
+    offset_ += consumed;
+    if (static_cast<std::size_t>(n) < buf_.size()) break;  // drained
+  }
+  return delivered;
+}
+
+void TailFollower::run(const RecordFn& fn) {
+  std::uint64_t since_checkpoint = 0;
+  while (!stop_.load(std::memory_order_acquire)) {
+    const std::uint64_t delivered = poll(fn);
+    since_checkpoint += delivered;
+
+    if (delivered == 0 || since_checkpoint >= opt_.checkpoint_every) {
+      checkpoint();
+      since_checkpoint = 0;
+    }
+    if (delivered != 0) continue;  // keep draining while data flows
+
+    // Idle: wait for a modification (or the poll interval as a fallback
+    // and stop() bound), then drain the inotify queue.
+    if (inotify_fd_ >= 0) {
+      struct pollfd pfd {
+        inotify_fd_, POLLIN, 0
+      };
+      ::poll(&pfd, 1, static_cast<int>(opt_.poll_interval.count()));
+      char events[4096];
+      bool moved = false;
+      while (true) {
+        const ssize_t n = ::read(inotify_fd_, events, sizeof(events));
+        if (n <= 0) break;
+        for (ssize_t at = 0; at < n;) {
+          const auto* ev = reinterpret_cast<inotify_event*>(events + at);
+          if (ev->mask & (IN_MOVE_SELF | IN_DELETE_SELF)) moved = true;
+          at += sizeof(inotify_event) + ev->len;
+        }
+      }
+      if (moved) {
+        // Rotation: finish the old file, then switch to the new one.
+        poll(fn);
+        if (reopen()) {
+          offset_ = 0;
+          if (watch_ >= 0) ::inotify_rm_watch(inotify_fd_, watch_);
+          watch_ = ::inotify_add_watch(
+              inotify_fd_, path_.c_str(),
+              IN_MODIFY | IN_MOVE_SELF | IN_DELETE_SELF);
+        }
+      }
+    } else {
+      struct timespec ts {
+        0, static_cast<long>(opt_.poll_interval.count()) * 1'000'000L
+      };
+      ::nanosleep(&ts, nullptr);
+    }
+  }
+  checkpoint();
+}
+
+}  // namespace jsonl
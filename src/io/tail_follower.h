@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace jsonl {
+
+// Incremental tail-follow over an append-only JSONL log.
+//
+// Delivers only records appended since the last checkpoint, watching the
+// file with inotify and sleeping between modifications, so a monitoring
+// consumer restart costs one checkpoint read instead of a full re-scan.
+// The checkpoint records byte offset, record count and file identity
+// (device + inode); if the identity changed — the log was rotated or
+// replaced — the follower starts over from byte zero rather than resuming
+// into the wrong file.
+//
+// Only complete (newline-terminated) records are delivered; a partially
+// written tail stays pending until its newline arrives, and checkpoints
+// never point into the middle of a record.
+class TailFollower {
+ public:
+  struct Options {
+    // Where to persist the checkpoint; defaults to "<log>.ckpt".
+    std::string checkpoint_path;
+    // Fallback wakeup period, and the stop() responsiveness bound.
+    std::chrono::milliseconds poll_interval{200};
+    // Persist the checkpoint after this many delivered records (and always
+    // when the follower goes idle).
+    std::uint64_t checkpoint_every = 100'000;
+  };
+
+  using RecordFn = std::function<void(std::string_view record,
+                                      std::uint64_t offset,
+                                      std::uint64_t record_number)>;
+
+  explicit TailFollower(const std::string& path);
+  TailFollower(const std::string& path, const Options& options);
+  ~TailFollower();
+
+  TailFollower(const TailFollower&) = delete;
+  TailFollower& operator=(const TailFollower&) = delete;
+
+  // Delivers currently appended complete records and returns their count.
+  // Non-blocking; does not persist the checkpoint by itself.
+  std::uint64_t poll(const RecordFn& fn);
+
+  // Follows the file until stop() is called (from the callback or another
+  // thread), checkpointing per Options.
+  void run(const RecordFn& fn);
+  void stop() noexcept { stop_.store(true, std::memory_order_release); }
+
+  // Persists the current position atomically (write + rename).
+  void checkpoint() const;
+
+  std::uint64_t offset() const noexcept { return offset_; }
+  std::uint64_t record_count() const noexcept { return records_; }
+
+ private:
+  void load_checkpoint();
+  bool reopen();  // (re)opens the log; true if identity changed
+
+  std::string path_;
+  Options opt_;
+  int fd_ = -1;
+  int inotify_fd_ = -1;
+  int watch_ = -1;
+  std::uint64_t dev_ = 0;
+  std::uint64_t inode_ = 0;
+  std::uint64_t offset_ = 0;   // start of the first undelivered record
+  std::uint64_t records_ = 0;  // records delivered so far
+  std::vector<char> buf_;
+  std::atomic<bool> stop_{false};
+};
+
+}  // namespace jsonl
@@ -0,0 +1,376 @@
+#include "io/uring_reader.h"
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#include "mem/buffer_pool.h"
+#include "perf/scan_stats.h"
+#include "perf/trace.h"
+
+namespace jsonl {
+
+namespace {
+
+// Raw syscall shims; the structures come straight from <linux/io_uring.h>
+// so no liburing is needed.
+int sys_io_uring_setup(unsigned entries, io_uring_params* p) noexcept {
+  return static_cast<int>(::syscall(__NR_io_uring_setup, entries, p));
+}
+int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete,
+                       unsigned flags) noexcept {
+  return static_cast<int>(
+      ::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags,
+                nullptr, 0));
+}
+int sys_io_uring_register(int fd, unsigned op, const void* arg,
+                          unsigned nr) noexcept {
+  return static_cast<int>(::syscall(__NR_io_uring_register, fd, op, arg, nr));
+}
+
+[[noreturn]] void throw_errno(int err, const char* what) {
+  throw std::system_error(err, std::generic_category(), what);
+}
+
+}  // namespace
+
+// Pointers into the mapped submission/completion rings. Loads of the
+// kernel-written indices use acquire ordering; stores of ours use release.
+struct UringReader::RingOffsets {
+  unsigned* sq_head;
+  unsigned* sq_tail;
+  unsigned* sq_mask;
+  unsigned* sq_array;
+  unsigned* cq_head;
+  unsigned* cq_tail;
+  unsigned* cq_mask;
+  io_uring_cqe* cqes;
+  io_uring_sqe* sqes;
+};
+
+bool UringReader::supported() noexcept {
+  static const bool ok = [] {
+    io_uring_params p;
+    std::memset(&p, 0, sizeof(p));
+    int fd = sys_io_uring_setup(1, &p);
+    if (fd < 0) return false;
+    ::close(fd);
+    return true;
+  }();
+  return ok;
+}
+
+UringReader::UringReader(const std::string& path)
+    : UringReader(path, Options()) {}
+
+UringReader::UringReader(const std::string& path, const Options& options)
+    : opt_(options) {
+  if (opt_.depth == 0) opt_.depth = 16;
+  if (opt_.block_size == 0) opt_.block_size = 1 << 20;
+
+  fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd_ < 0) throw_errno(errno, "open");
+
+  struct stat st;
+  if (::fstat(fd_, &st) != 0) {
+    int err = errno;
+    ::close(fd_);
+    throw_errno(err, "fstat");
+  }
+  file_size_ = static_cast<std::uint64_t>(st.st_size);
+
+  io_uring_params p;
+  std::memset(&p, 0, sizeof(p));
+  ring_fd_ = sys_io_uring_setup(opt_.depth, &p);
+  if (ring_fd_ < 0) {
+    ::close(fd_);
+    throw std::runtime_error("io_uring not supported by this kernel");
+  }
+
+  sq_ring_size_ = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+  sqes_size_ = p.sq_entries * sizeof(io_uring_sqe);
+
+  sq_ring_ = ::mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+  cq_ring_ = ::mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_CQ_RING);
+  sqes_ = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+  if (sq_ring_ == MAP_FAILED || cq_ring_ == MAP_FAILED ||
+      sqes_ == MAP_FAILED) {
+    cleanup();
+    throw std::runtime_error("io_uring ring mmap failed");
+  }
+
+  char* sq = static_cast<char*>(sq_ring_);
+  char* cq = static_cast<char*>(cq_ring_);
+  off_ = new RingOffsets{
+      reinterpret_cast<unsigned*>(sq + p.sq_off.head),
+      reinterpret_cast<unsigned*>(sq + p.sq_off.tail),
+      reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask),
+      reinterpret_cast<unsigned*>(sq + p.sq_off.array),
+      reinterpret_cast<unsigned*>(cq + p.cq_off.head),
+      reinterpret_cast<unsigned*>(cq + p.cq_off.tail),
+      reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask),
+      reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes),
+      static_cast<io_uring_sqe*>(sqes_),
+  };
+
+  // Registered buffers: fixed for the life of the reader, so steady state
+  // performs no per-op allocation or page pinning. Pool-backed, so a
+  // reopened reader reuses the previous one's (possibly huge-page) blocks.
+  buffers_.resize(opt_.depth);
+  std::vector<iovec> iov(opt_.depth);
+  for (unsigned i = 0; i < opt_.depth; ++i) {
+    try {
+      buffers_[i] = static_cast<char*>(
+          BufferPool::instance().acquire(opt_.block_size, buffer_bytes_));
+    } catch (...) {
+      cleanup();
+      throw;
+    }
+    iov[i] = {buffers_[i], opt_.block_size};
+  }
+  if (sys_io_uring_register(ring_fd_, IORING_REGISTER_BUFFERS, iov.data(),
+                            opt_.depth) < 0) {
+    int err = errno;
+    cleanup();
+    throw_errno(err, "io_uring_register(BUFFERS)");
+  }
+
+  blocks_.resize(opt_.depth);
+  free_.reserve(opt_.depth);
+  for (unsigned i = 0; i < opt_.depth; ++i) free_.push_back(i);
+  submit_reads();
+}
+
+UringReader::~UringReader() { cleanup(); }
+
+void UringReader::cleanup() noexcept {
+  delete off_;
+  off_ = nullptr;
+  if (sq_ring_ != nullptr && sq_ring_ != MAP_FAILED) {
+    ::munmap(sq_ring_, sq_ring_size_);
+  }
+  if (cq_ring_ != nullptr && cq_ring_ != MAP_FAILED) {
+    ::munmap(cq_ring_, cq_ring_size_);
+  }
+  if (sqes_ != nullptr && sqes_ != MAP_FAILED) ::munmap(sqes_, sqes_size_);
+  sq_ring_ = cq_ring_ = sqes_ = nullptr;
+  for (char* b : buffers_) {
+    if (b != nullptr) BufferPool::instance().release(b, buffer_bytes_);
+  }
+  buffers_.clear();
+  if (ring_fd_ >= 0) ::close(ring_fd_);
+  if (fd_ >= 0) ::close(fd_);
+  ring_fd_ = fd_ = -1;
+}
+
+void UringReader::submit_reads() {
+  perf::TraceSpan span("uring_submit");
+  unsigned queued = 0;
+  while (!free_.empty() && submit_offset_ < file_size_) {
+    const std::uint32_t slot = free_.back();
+    free_.pop_back();
+
+    Block& b = blocks_[slot];
+    b.file_offset = submit_offset_;
+    b.expected = static_cast<std::uint32_t>(
+        std::min<std::uint64_t>(opt_.block_size, file_size_ - submit_offset_));
+    b.filled = 0;
+    b.ready = false;
+    b.in_flight = true;
+    submit_offset_ += b.expected;
+    order_.push_back(slot);
+
+    const unsigned mask = *off_->sq_mask;
+    const unsigned tail = __atomic_load_n(off_->sq_tail, __ATOMIC_RELAXED);
+    io_uring_sqe* sqe = &off_->sqes[tail & mask];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_READ_FIXED;
+    sqe->fd = fd_;
+    sqe->addr = reinterpret_cast<std::uint64_t>(buffers_[slot]);
+    sqe->len = b.expected;
+    sqe->off = b.file_offset;
+    sqe->buf_index = static_cast<std::uint16_t>(slot);
+    sqe->user_data = slot;
+    off_->sq_array[tail & mask] = tail & mask;
+    __atomic_store_n(off_->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    ++queued;
+  }
+  if (queued != 0 && sys_io_uring_enter(ring_fd_, queued, 0, 0) < 0) {
+    throw_errno(errno, "io_uring_enter(submit)");
+  }
+}
+
+void UringReader::reap(bool wait) {
+  perf::TraceSpan span("uring_reap");
+  if (wait) {
+    if (sys_io_uring_enter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS) < 0 &&
+        errno != EINTR) {
+      throw_errno(errno, "io_uring_enter(wait)");
+    }
+  }
+  const unsigned mask = *off_->cq_mask;
+  unsigned head = __atomic_load_n(off_->cq_head, __ATOMIC_RELAXED);
+  const unsigned tail = __atomic_load_n(off_->cq_tail, __ATOMIC_ACQUIRE);
+  unsigned resubmits = 0;
+  while (head != tail) {
+    const io_uring_cqe& cqe = off_->cqes[head & mask];
+    const std::uint32_t slot = static_cast<std::uint32_t>(cqe.user_data);
+    Block& b = blocks_[slot];
+    if (cqe.res < 0) throw_errno(-cqe.res, "io_uring read");
+    b.filled += static_cast<std::uint32_t>(cqe.res);
+    perf::counters().bytes_read.fetch_add(
+        static_cast<std::uint64_t>(cqe.res), std::memory_order_relaxed);
+    if (cqe.res == 0 || b.filled >= b.expected) {
+      // Short terminal read only happens if the file shrank under us;
+      // deliver what arrived.
+      b.expected = b.filled;
+      b.ready = true;
+      b.in_flight = false;
+    } else {
+      // Short read mid-block: continue the block from where it stopped.
+      const unsigned smask = *off_->sq_mask;
+      const unsigned stail =
+          __atomic_load_n(off_->sq_tail, __ATOMIC_RELAXED);
+      io_uring_sqe* sqe = &off_->sqes[stail & smask];
+      std::memset(sqe, 0, sizeof(*sqe));
+      sqe->opcode = IORING_OP_READ_FIXED;
+      sqe->fd = fd_;
+      sqe->addr = reinterpret_cast<std::uint64_t>(buffers_[slot] + b.filled);
+      sqe->len = b.expected - b.filled;
+      sqe->off = b.file_offset + b.filled;
+      sqe->buf_index = static_cast<std::uint16_t>(slot);
+      sqe->user_data = slot;
+      off_->sq_array[stail & smask] = stail & smask;
+      __atomic_store_n(off_->sq_tail, stail + 1, __ATOMIC_RELEASE);
+      ++resubmits;
+    }
+    ++head;
+    __atomic_store_n(off_->cq_head, head, __ATOMIC_RELEASE);
+  }
+  if (resubmits != 0 &&
+      sys_io_uring_enter(ring_fd_, resubmits, 0, 0) < 0) {
+    throw_errno(errno, "io_uring_enter(resubmit)");
+  }
+}
+
+bool UringReader::refill() {
+  while (true) {
+    if (order_.empty()) {
+      submit_reads();
+      if (order_.empty()) return false;  // everything consumed: EOF
+    }
+    const std::uint32_t front = order_.front();
+    if (blocks_[front].ready) {
+      cur_slot_ = front;
+      cur_pos_ = 0;
+      cur_valid_ = true;
+      return true;
+    }
+    reap(true);
+  }
+}
+
+bool UringReader::drain_carry(std::string_view& record) {
+  if (carry_.empty()) return false;
+  stitched_ = std::move(carry_);
+  carry_.clear();
+  record = stitched_;
+  consumed_ = file_size_;
+  return true;
+}
+
+bool UringReader::extract(std::string_view& record) {
+  const Block& b = blocks_[cur_slot_];
+  const char* data = buffers_[cur_slot_];
+  const std::size_t limit = b.filled;
+  const char* nl = static_cast<const char*>(
+      std::memchr(data + cur_pos_, '\n', limit - cur_pos_));
+
+  if (nl != nullptr) {
+    const std::size_t end = static_cast<std::size_t>(nl - data);
+    if (carry_.empty()) {
+      record = {data + cur_pos_, end - cur_pos_};
+    } else {
+      carry_.append(data + cur_pos_, end - cur_pos_);
+      stitched_ = std::move(carry_);
+      carry_.clear();
+      record = stitched_;
+    }
+    consumed_ = b.file_offset + end + 1;
+    cur_pos_ = end + 1;
+    if (cur_pos_ >= limit) {
+      // The record we are about to return may point into this buffer;
+      // recycling the slot now would let a fresh READ_FIXED overwrite it
+      // while the caller still holds the view. Park it instead — the
+      // next call releases it once the view is invalid by contract.
+      order_.pop_front();
+      retired_slot_ = static_cast<std::int32_t>(cur_slot_);
+      cur_valid_ = false;
+      submit_reads();
+    }
+    return true;
+  }
+
+  // No newline left in this block: stash the tail and move on.
+  carry_.append(data + cur_pos_, limit - cur_pos_);
+  order_.pop_front();
+  free_.push_back(cur_slot_);
+  cur_valid_ = false;
+  submit_reads();
+  return false;
+}
+
+void UringReader::release_retired() {
+  if (retired_slot_ >= 0) {
+    free_.push_back(static_cast<std::uint32_t>(retired_slot_));
+    retired_slot_ = -1;
+  }
+}
+
+bool UringReader::next(std::string_view& record) {
+  release_retired();
+  while (true) {
+    if (!cur_valid_ && !refill()) return drain_carry(record);
+    if (extract(record)) return true;
+  }
+}
+
+UringReader::Poll UringReader::poll_next(std::string_view& record) {
+  release_retired();
+  while (true) {
+    if (!cur_valid_) {
+      if (order_.empty()) {
+        submit_reads();
+        if (order_.empty()) {
+          return drain_carry(record) ? Poll::kReady : Poll::kEnd;
+        }
+      }
+      const std::uint32_t front = order_.front();
+      if (!blocks_[front].ready) {
+        reap(false);
+        if (!blocks_[front].ready) return Poll::kPending;
+      }
+      cur_slot_ = front;
+      cur_pos_ = 0;
+      cur_valid_ = true;
+    }
+    if (extract(record)) return Poll::kReady;
+  }
+}
+
+}  // namespace jsonl
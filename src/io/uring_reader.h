@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "io/reader.h"
+
+namespace jsonl {
+
+// io_uring prefetch backend for cold sequential scans.
+//
+// The mmap path faults pages on demand, which leaves the device idle
+// between faults and caps cold-scan throughput well below what the array
+// can sustain. This reader instead keeps a deep queue of fixed-size reads
+// in flight via io_uring (raw syscalls — no liburing dependency), using
+// registered buffers so steady-state operation performs no per-op
+// allocation or buffer mapping. Blocks complete out of order; delivery
+// reorders them and stitches records that straddle block boundaries
+// through a small carry buffer.
+//
+// Requires a 5.1+ kernel with io_uring enabled; construction throws
+// std::runtime_error otherwise (see supported()).
+class UringReader final : public Reader {
+ public:
+  struct Options {
+    unsigned depth = 16;             // blocks kept in flight
+    std::size_t block_size = 1 << 20;
+  };
+
+  explicit UringReader(const std::string& path);
+  UringReader(const std::string& path, const Options& options);
+  ~UringReader() override;
+
+  UringReader(const UringReader&) = delete;
+  UringReader& operator=(const UringReader&) = delete;
+
+  bool next(std::string_view& record) override;
+  std::uint64_t offset() const noexcept override { return consumed_; }
+
+  // Non-blocking variant for async consumers: kReady delivers a record,
+  // kPending means the next block is still in flight (completions were
+  // reaped without waiting), kEnd is EOF. next() is poll_next() that waits
+  // out kPending.
+  enum class Poll { kReady, kPending, kEnd };
+  Poll poll_next(std::string_view& record);
+
+  // Whether this kernel accepts io_uring_setup. Probed once and cached.
+  static bool supported() noexcept;
+
+ private:
+  struct Block {
+    std::uint64_t file_offset = 0;
+    std::uint32_t expected = 0;  // bytes requested
+    std::uint32_t filled = 0;    // bytes completed so far
+    bool ready = false;
+    bool in_flight = false;
+  };
+
+  void cleanup() noexcept;
+  void submit_reads();
+  void reap(bool wait);
+  bool refill();  // makes front block consumable; false at EOF
+  // Scans the current block for the next record; false when the block is
+  // exhausted (cur_valid_ cleared, tail moved to carry_).
+  bool extract(std::string_view& record);
+  bool drain_carry(std::string_view& record);  // EOF: flush partial tail
+  void release_retired();  // recycle the slot parked by extract()
+
+  int fd_ = -1;
+  int ring_fd_ = -1;
+  std::uint64_t file_size_ = 0;
+  std::uint64_t submit_offset_ = 0;  // next file offset to request
+  std::uint64_t consumed_ = 0;       // next record start, absolute
+  Options opt_;
+
+  // Ring mappings (raw io_uring plumbing, see uring_reader.cpp).
+  void* sq_ring_ = nullptr;
+  std::size_t sq_ring_size_ = 0;
+  void* cq_ring_ = nullptr;
+  std::size_t cq_ring_size_ = 0;
+  void* sqes_ = nullptr;
+  std::size_t sqes_size_ = 0;
+  struct RingOffsets;
+  RingOffsets* off_ = nullptr;
+
+  std::vector<char*> buffers_;        // registered, opt_.depth blocks
+  std::size_t buffer_bytes_ = 0;      // pool-rounded size of each block
+  std::vector<Block> blocks_;         // state per buffer slot
+  std::deque<std::uint32_t> order_;   // slots in file order, oldest first
+  std::vector<std::uint32_t> free_;   // slots available for new reads
+
+  // Current consumable block and position within it.
+  std::uint32_t cur_slot_ = 0;
+  std::size_t cur_pos_ = 0;
+  bool cur_valid_ = false;
+
+  // Slot whose buffer the most recently returned view may still alias;
+  // recycled only once the next call invalidates the view (-1 = none).
+  std::int32_t retired_slot_ = -1;
+
+  std::string carry_;    // partial record spanning block boundaries
+  std::string stitched_; // backing store for records assembled from carry_
+};
+
+}  // namespace jsonl
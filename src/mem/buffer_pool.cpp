@@ -0,0 +1,93 @@
+#include "mem/buffer_pool.h"
+
+#include <sys/mman.h>
+
+#include <new>
+
+namespace jsonl {
+
+namespace {
+
+constexpr std::size_t kHugePage = 2u << 20;
+
+unsigned class_shift(std::size_t size) noexcept {
+  unsigned shift = 16;
+  while ((std::size_t{1} << shift) < size) ++shift;
+  return shift;
+}
+
+std::size_t page_round(std::size_t size) noexcept {
+  return (size + 4095) & ~std::size_t{4095};
+}
+
+}  // namespace
+
+BufferPool& BufferPool::instance() noexcept {
+  static BufferPool pool;
+  return pool;
+}
+
+BufferPool::~BufferPool() {
+  for (unsigned c = 0; c < kClasses; ++c) {
+    const std::size_t size = std::size_t{1} << (kMinShift + c);
+    for (void* p : free_[c]) ::munmap(p, size);
+  }
+}
+
+void* BufferPool::map_new(std::size_t size) {
+  void* p = MAP_FAILED;
+  if (size >= kHugePage && (size & (kHugePage - 1)) == 0) {
+    p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (p != MAP_FAILED) ++stats_.hugetlb_buffers;
+  }
+  if (p == MAP_FAILED) {
+    p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) throw std::bad_alloc();
+    if (size >= kHugePage) ::madvise(p, size, MADV_HUGEPAGE);
+  }
+  ++stats_.maps;
+  stats_.bytes_mapped += size;
+  return p;
+}
+
+void* BufferPool::acquire(std::size_t size, std::size_t& actual) {
+  const unsigned shift = class_shift(size);
+  if (shift > kMaxShift) {
+    // Oversize: direct mapping, returned to the kernel on release.
+    actual = page_round(size);
+    std::lock_guard lock(mutex_);
+    return map_new(actual);
+  }
+  actual = std::size_t{1} << shift;
+  const unsigned c = shift - kMinShift;
+
+  std::lock_guard lock(mutex_);
+  if (!free_[c].empty()) {
+    void* p = free_[c].back();
+    free_[c].pop_back();
+    ++stats_.reuses;
+    return p;
+  }
+  return map_new(actual);
+}
+
+void BufferPool::release(void* p, std::size_t actual) noexcept {
+  if (p == nullptr) return;
+  const unsigned shift = class_shift(actual);
+  if (shift > kMaxShift || actual != (std::size_t{1} << shift)) {
+    ::munmap(p, actual);
+    return;
+  }
+  const unsigned c = shift - kMinShift;
+  std::lock_guard lock(mutex_);
+  free_[c].push_back(p);
+}
+
+BufferPool::Stats BufferPool::stats() const noexcept {
+  std::lock_guard lock(mutex_);
+  return stats_;
+}
+
+}  // namespace jsonl
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace jsonl {
+
+// Central recycling allocator for scan-path buffers (io blocks, arena
+// chains, writer rings).
+//
+// Buffers are mmap-backed in power-of-two size classes from 64 KiB to
+// 64 MiB. Classes of 2 MB and up are requested as explicit huge pages
+// first (MAP_HUGETLB) and fall back to ordinary pages flagged
+// MADV_HUGEPAGE for transparent promotion, so large-scan TLB pressure
+// drops whether or not the host reserves a hugetlb pool. Released
+// buffers go onto per-class free lists and come back dirty: steady-state
+// scanning performs zero mmap/munmap calls and never re-pays the
+// page-zeroing cost a fresh mapping carries.
+//
+// Oversize requests (beyond the largest class) map and unmap directly.
+// acquire/release take a mutex per call; consumers allocate whole blocks,
+// not individual nodes, so the lock is off every hot path.
+class BufferPool {
+ public:
+  BufferPool() = default;
+  ~BufferPool();
+
+  BufferPool(const BufferPool&) = delete;
+  BufferPool& operator=(const BufferPool&) = delete;
+
+  // Process-wide pool shared by arenas, readers and writers.
+  static BufferPool& instance() noexcept;
+
+  // Returns a buffer of at least `size` bytes; `actual` receives the
+  // usable (class-rounded) size, which release() needs back. Throws
+  // std::bad_alloc if the mapping fails.
+  void* acquire(std::size_t size, std::size_t& actual);
+  void release(void* p, std::size_t actual) noexcept;
+
+  struct Stats {
+    std::uint64_t maps = 0;     // fresh mmap calls
+    std::uint64_t reuses = 0;   // acquires served from a free list
+    std::uint64_t bytes_mapped = 0;
+    std::uint64_t hugetlb_buffers = 0;  // explicit huge-page successes
+  };
+  Stats stats() const noexcept;
+
+ private:
+  static constexpr unsigned kMinShift = 16;  // 64 KiB
+  static constexpr unsigned kMaxShift = 26;  // 64 MiB
+  static constexpr unsigned kClasses = kMaxShift - kMinShift + 1;
+
+  void* map_new(std::size_t size);
+
+  mutable std::mutex mutex_;
+  std::vector<void*> free_[kClasses];
+  Stats stats_;
+};
+
+}  // namespace jsonl
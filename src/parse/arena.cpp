@@ -0,0 +1,69 @@
+#include "parse/arena.h"
+
+#include "mem/buffer_pool.h"
+#include "perf/scan_stats.h"
+
+namespace jsonl {
+
+Arena::~Arena() { release(); }
+
+void* Arena::allocate_slow(std::size_t size, std::size_t align) {
+  // Advance through already-chained blocks (repopulated by reset()) before
+  // asking the system for more.
+  Block* tail = current_;
+  Block* b = current_ != nullptr ? current_->next : head_;
+  while (b != nullptr) {
+    std::size_t aligned = (b->used + (align - 1)) & ~(align - 1);
+    if (aligned + size <= b->capacity) {
+      b->used = aligned + size;
+      current_ = b;
+      bytes_allocated_ += size;
+      return b->data() + aligned;
+    }
+    tail = b;
+    b = b->next;
+  }
+
+  std::size_t want = block_size_;
+  if (size + align > want) want = size + align;
+  std::size_t mapped;
+  Block* fresh = static_cast<Block*>(
+      BufferPool::instance().acquire(sizeof(Block) + want, mapped));
+  fresh->next = nullptr;
+  fresh->capacity = mapped - sizeof(Block);
+  perf::counters().arena_block_bytes.fetch_add(fresh->capacity,
+                                               std::memory_order_relaxed);
+
+  std::uintptr_t base = reinterpret_cast<std::uintptr_t>(fresh->data());
+  std::size_t aligned = ((base + (align - 1)) & ~(align - 1)) - base;
+  fresh->used = aligned + size;
+
+  if (tail != nullptr) {
+    tail->next = fresh;
+  } else {
+    head_ = fresh;
+  }
+  current_ = fresh;
+  bytes_allocated_ += size;
+  return fresh->data() + aligned;
+}
+
+void Arena::reset() noexcept {
+  for (Block* b = head_; b != nullptr; b = b->next) b->used = 0;
+  current_ = head_;
+  bytes_allocated_ = 0;
+}
+
+void Arena::release() noexcept {
+  Block* b = head_;
+  while (b != nullptr) {
+    Block* next = b->next;
+    BufferPool::instance().release(b, sizeof(Block) + b->capacity);
+    b = next;
+  }
+  head_ = nullptr;
+  current_ = nullptr;
+  bytes_allocated_ = 0;
+}
+
+}  // namespace jsonl
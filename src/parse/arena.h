@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace jsonl {
+
+// Bump allocator backing per-batch parse output.
+//
+// Allocation is a pointer increment into the current block; blocks are
+// chained as needed and never individually freed. reset() rewinds all blocks
+// for reuse without returning memory to the system, so a long-running scan
+// that resets between batches performs no per-node malloc/free and does not
+// fragment the heap.
+class Arena {
+ public:
+  static constexpr std::size_t kDefaultBlockSize = 64 * 1024;
+
+  explicit Arena(std::size_t block_size = kDefaultBlockSize)
+      : block_size_(block_size) {}
+  ~Arena();
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  void* allocate(std::size_t size,
+                 std::size_t align = alignof(std::max_align_t)) {
+    Block* b = current_;
+    if (b != nullptr) {
+      std::size_t aligned = (b->used + (align - 1)) & ~(align - 1);
+      if (aligned + size <= b->capacity) {
+        b->used = aligned + size;
+        return b->data() + aligned;
+      }
+    }
+    return allocate_slow(size, align);
+  }
+
+  template <typename T>
+  T* make_array(std::size_t n) {
+    return static_cast<T*>(allocate(n * sizeof(T), alignof(T)));
+  }
+
+  // Rewinds every block for reuse. Does not run destructors; arena clients
+  // store trivially-destructible nodes only.
+  void reset() noexcept;
+
+  // Frees all blocks.
+  void release() noexcept;
+
+  // Total bytes currently handed out (since construction or last reset).
+  std::size_t bytes_allocated() const noexcept { return bytes_allocated_; }
+
+ private:
+  struct Block {
+    Block* next;
+    std::size_t capacity;
+    std::size_t used;
+    char* data() noexcept { return reinterpret_cast<char*>(this + 1); }
+  };
+
+  void* allocate_slow(std::size_t size, std::size_t align);
+
+  Block* head_ = nullptr;     // first block, start of reuse chain
+  Block* current_ = nullptr;  // block serving allocations
+  std::size_t block_size_;
+  std::size_t bytes_allocated_ = 0;
+};
+
+}  // namespace jsonl
@@ -0,0 +1,99 @@
+#include "parse/intern_table.h"
+
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+
+namespace jsonl {
+
+namespace {
+
+// FNV-1a, good enough for short field values; the table compares full
+// strings on probe hits so hash quality only affects probe length.
+std::uint64_t hash_bytes(std::string_view s) noexcept {
+  std::uint64_t h = 0xcbf29ce484222325ull;
+  for (char c : s) {
+    h ^= static_cast<unsigned char>(c);
+    h *= 0x100000001b3ull;
+  }
+  return h;
+}
+
+std::size_t table_size_for(std::size_t symbols) noexcept {
+  std::size_t n = 16;
+  while (n * 7 / 10 < symbols) n <<= 1;
+  return n;
+}
+
+}  // namespace
+
+InternTable::InternTable(std::size_t expected_symbols)
+    : slots_(table_size_for(expected_symbols), 0) {}
+
+std::uint32_t InternTable::find_locked(std::string_view s,
+                                       std::uint64_t hash) const {
+  const std::size_t mask = slots_.size() - 1;
+  for (std::size_t i = hash & mask;; i = (i + 1) & mask) {
+    const std::uint32_t slot = slots_[i];
+    if (slot == 0) return kNoSymbol;
+    if (symbols_[slot - 1] == s) return slot - 1;
+  }
+}
+
+std::uint32_t InternTable::find(std::string_view s) const {
+  std::shared_lock lock(mutex_);
+  return find_locked(s, hash_bytes(s));
+}
+
+std::uint32_t InternTable::intern(std::string_view s) {
+  const std::uint64_t hash = hash_bytes(s);
+  {
+    std::shared_lock lock(mutex_);
+    const std::uint32_t id = find_locked(s, hash);
+    if (id != kNoSymbol) return id;
+  }
+
+  std::unique_lock lock(mutex_);
+  // Re-check: another thread may have interned it between the locks.
+  const std::uint32_t id = find_locked(s, hash);
+  if (id != kNoSymbol) return id;
+
+  if (symbols_.size() >= slots_.size() * 7 / 10) grow_locked();
+  if (symbols_.size() >= 0xfffffffeull) {
+    throw std::length_error("InternTable: symbol space exhausted");
+  }
+
+  char* copy = storage_.make_array<char>(s.size());
+  std::memcpy(copy, s.data(), s.size());
+  symbols_.emplace_back(copy, s.size());
+  const std::uint32_t fresh = static_cast<std::uint32_t>(symbols_.size() - 1);
+
+  const std::size_t mask = slots_.size() - 1;
+  std::size_t i = hash & mask;
+  while (slots_[i] != 0) i = (i + 1) & mask;
+  slots_[i] = fresh + 1;
+  return fresh;
+}
+
+void InternTable::grow_locked() {
+  std::vector<std::uint32_t> fresh(slots_.size() * 2, 0);
+  const std::size_t mask = fresh.size() - 1;
+  for (std::uint32_t id = 0; id < symbols_.size(); ++id) {
+    std::size_t i = hash_bytes(symbols_[id]) & mask;
+    while (fresh[i] != 0) i = (i + 1) & mask;
+    fresh[i] = id + 1;
+  }
+  slots_ = std::move(fresh);
+}
+
+std::string_view InternTable::symbol(std::uint32_t id) const {
+  std::shared_lock lock(mutex_);
+  return symbols_.at(id);
+}
+
+std::size_t InternTable::size() const {
+  std::shared_lock lock(mutex_);
+  return symbols_.size();
+}
+
+}  // namespace jsonl
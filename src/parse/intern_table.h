@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <shared_mutex>
+#include <string_view>
+#include <vector>
+
+#include "parse/arena.h"
+
+namespace jsonl {
+
+// Shared dictionary mapping repeated field values to dense 32-bit symbol
+// IDs.
+//
+// Endpoint names, user agents and status labels repeat millions of times
+// per log; interning them once turns later group-by and comparison work
+// into integer operations with no hashing of the full string and no
+// allocation after first sight. The table is open-addressing with linear
+// probing, sized to stay under 70% load, and read-mostly: lookups of
+// already-interned strings take a shared lock, only genuinely new strings
+// take the exclusive path. String bytes live in an internal arena, so
+// symbol() views stay stable for the table's lifetime.
+//
+// IDs are dense, starting at 0 in insertion order — convenient as direct
+// indexes into per-symbol accumulator arrays.
+class InternTable {
+ public:
+  static constexpr std::uint32_t kNoSymbol = 0xffffffffu;
+
+  explicit InternTable(std::size_t expected_symbols = 1024);
+
+  InternTable(const InternTable&) = delete;
+  InternTable& operator=(const InternTable&) = delete;
+
+  // Returns the symbol for `s`, inserting it if new.
+  std::uint32_t intern(std::string_view s);
+
+  // Returns the symbol for `s` or kNoSymbol; never inserts.
+  std::uint32_t find(std::string_view s) const;
+
+  // The interned bytes for a symbol returned by intern()/find().
+  std::string_view symbol(std::uint32_t id) const;
+
+  std::size_t size() const;
+
+ private:
+  std::uint32_t find_locked(std::string_view s, std::uint64_t hash) const;
+  void grow_locked();
+
+  mutable std::shared_mutex mutex_;
+  std::vector<std::uint32_t> slots_;  // symbol id + 1; 0 = empty
+  std::vector<std::string_view> symbols_;
+  Arena storage_;
+};
+
+}  // namespace jsonl
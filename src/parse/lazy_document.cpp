@@ -0,0 +1,330 @@
+#include "parse/lazy_document.h"
+
+#include <cstring>
+
+#include "parse/intern_table.h"
+#include "parse/number_kernels.h"
+#include "perf/scan_stats.h"
+
+namespace jsonl {
+
+namespace {
+
+inline bool is_ws(char c) noexcept {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// Advances past the closing quote of a string whose opening quote is at
+// pos. Returns the position one past the closing quote, or npos.
+std::size_t skip_string(std::string_view s, std::size_t pos) noexcept {
+  for (++pos; pos < s.size(); ++pos) {
+    if (s[pos] == '\\') {
+      ++pos;
+    } else if (s[pos] == '"') {
+      return pos + 1;
+    }
+  }
+  return std::string_view::npos;
+}
+
+// Advances past a bracketed value (object or array) by depth counting,
+// ignoring brackets inside strings.
+std::size_t skip_nested(std::string_view s, std::size_t pos, char open,
+                        char close) noexcept {
+  int depth = 0;
+  while (pos < s.size()) {
+    char c = s[pos];
+    if (c == '"') {
+      pos = skip_string(s, pos);
+      if (pos == std::string_view::npos) return pos;
+      continue;
+    }
+    if (c == open) {
+      ++depth;
+    } else if (c == close) {
+      if (--depth == 0) return pos + 1;
+    }
+    ++pos;
+  }
+  return std::string_view::npos;
+}
+
+// Advances past a number / true / false / null literal.
+std::size_t skip_literal(std::string_view s, std::size_t pos) noexcept {
+  while (pos < s.size()) {
+    char c = s[pos];
+    if (c == ',' || c == '}' || c == ']' || is_ws(c)) break;
+    ++pos;
+  }
+  return pos;
+}
+
+// Parses the four hex digits of a \uXXXX escape. Returns -1 on bad input.
+int parse_hex4(const char* p) noexcept {
+  int out = 0;
+  for (int i = 0; i < 4; ++i) {
+    const char c = p[i];
+    int digit;
+    if (c >= '0' && c <= '9') {
+      digit = c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+      digit = c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+      digit = c - 'A' + 10;
+    } else {
+      return -1;
+    }
+    out = (out << 4) | digit;
+  }
+  return out;
+}
+
+// Appends the UTF-8 encoding of a code point. The caller has already
+// rejected unpaired surrogates, so cp is a valid scalar value.
+char* encode_utf8(char* out, std::uint32_t cp) noexcept {
+  if (cp < 0x80) {
+    *out++ = static_cast<char>(cp);
+  } else if (cp < 0x800) {
+    *out++ = static_cast<char>(0xC0 | (cp >> 6));
+    *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+  } else if (cp < 0x10000) {
+    *out++ = static_cast<char>(0xE0 | (cp >> 12));
+    *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+  } else {
+    *out++ = static_cast<char>(0xF0 | (cp >> 18));
+    *out++ = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+    *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+  }
+  return out;
+}
+
+}  // namespace
+
+std::string_view Value::as_string(std::string_view dflt) const noexcept {
+  if (type_ != ValueType::kString || raw_.size() < 2) return dflt;
+  return raw_.substr(1, raw_.size() - 2);
+}
+
+std::string_view Value::as_string_unescaped(Arena& arena,
+                                            std::string_view dflt) const {
+  if (type_ != ValueType::kString || raw_.size() < 2) return dflt;
+  const std::string_view s = raw_.substr(1, raw_.size() - 2);
+  if (std::memchr(s.data(), '\\', s.size()) == nullptr) return s;
+
+  // Decoded output never exceeds the escaped form: two-character escapes
+  // shrink to one byte and \uXXXX (6 or 12 chars) to at most 4.
+  char* const buf = arena.make_array<char>(s.size());
+  char* out = buf;
+  std::size_t i = 0;
+  while (i < s.size()) {
+    const char c = s[i];
+    if (c != '\\') {
+      *out++ = c;
+      ++i;
+      continue;
+    }
+    if (i + 1 >= s.size()) return dflt;
+    const char esc = s[i + 1];
+    i += 2;
+    switch (esc) {
+      case '"':
+      case '\\':
+      case '/':
+        *out++ = esc;
+        break;
+      case 'b':
+        *out++ = '\b';
+        break;
+      case 'f':
+        *out++ = '\f';
+        break;
+      case 'n':
+        *out++ = '\n';
+        break;
+      case 'r':
+        *out++ = '\r';
+        break;
+      case 't':
+        *out++ = '\t';
+        break;
+      case 'u': {
+        if (i + 4 > s.size()) return dflt;
+        int cp = parse_hex4(s.data() + i);
+        if (cp < 0) return dflt;
+        i += 4;
+        if (cp >= 0xD800 && cp <= 0xDBFF) {
+          // High surrogate: must be followed by a low-surrogate escape.
+          if (i + 6 > s.size() || s[i] != '\\' || s[i + 1] != 'u') return dflt;
+          const int lo = parse_hex4(s.data() + i + 2);
+          if (lo < 0xDC00 || lo > 0xDFFF) return dflt;
+          i += 6;
+          cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+        } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+          return dflt;  // unpaired low surrogate
+        }
+        out = encode_utf8(out, static_cast<std::uint32_t>(cp));
+        break;
+      }
+      default:
+        return dflt;
+    }
+  }
+  return {buf, static_cast<std::size_t>(out - buf)};
+}
+
+std::uint32_t Value::as_symbol(InternTable& table) const {
+  if (type_ != ValueType::kString) return InternTable::kNoSymbol;
+  return table.intern(as_string());
+}
+
+std::int64_t Value::as_int64(std::int64_t dflt) const noexcept {
+  if (type_ != ValueType::kNumber) return dflt;
+  std::int64_t out = 0;
+  return parse_int(raw_, out) ? out : dflt;
+}
+
+double Value::as_double(double dflt) const noexcept {
+  if (type_ != ValueType::kNumber) return dflt;
+  double out = 0.0;
+  return parse_float(raw_, out) ? out : dflt;
+}
+
+std::int64_t Value::as_timestamp_ms(std::int64_t dflt) const noexcept {
+  if (type_ == ValueType::kNumber) return as_int64(dflt);
+  if (type_ != ValueType::kString) return dflt;
+  std::int64_t out = 0;
+  return parse_ts(as_string(), out) ? out : dflt;
+}
+
+bool Value::as_bool(bool dflt) const noexcept {
+  if (type_ != ValueType::kBool) return dflt;
+  return !raw_.empty() && raw_[0] == 't';
+}
+
+LazyDocument::LazyDocument(std::string_view record, Arena& arena)
+    : record_(record), arena_(&arena) {
+  perf::counters().records_parsed.fetch_add(1, std::memory_order_relaxed);
+  // Position past the opening '{'; everything else waits for first access.
+  while (pos_ < record_.size() && is_ws(record_[pos_])) ++pos_;
+  if (pos_ >= record_.size() || record_[pos_] != '{') {
+    done_ = true;
+  } else {
+    ++pos_;
+  }
+}
+
+Value LazyDocument::operator[](std::string_view key) {
+  for (std::size_t i = 0; i < size_; ++i) {
+    if (fields_[i].key == key) return fields_[i].value;
+  }
+  while (advance()) {
+    if (fields_[size_ - 1].key == key) return fields_[size_ - 1].value;
+  }
+  return Value();
+}
+
+Value LazyDocument::field_at(std::size_t index, std::string_view expected_key) {
+  while (size_ <= index && advance()) {
+  }
+  if (index < size_ && fields_[index].key == expected_key) {
+    return fields_[index].value;
+  }
+  return (*this)[expected_key];
+}
+
+std::size_t LazyDocument::parse_all() {
+  while (advance()) {
+  }
+  return size_;
+}
+
+void LazyDocument::append(const Field& f) {
+  if (size_ == capacity_) {
+    std::size_t next = capacity_ == 0 ? 8 : capacity_ * 2;
+    Field* grown = arena_->make_array<Field>(next);
+    if (size_ > 0) std::memcpy(grown, fields_, size_ * sizeof(Field));
+    fields_ = grown;
+    capacity_ = next;
+  }
+  fields_[size_++] = f;
+}
+
+bool LazyDocument::advance() {
+  if (done_) return false;
+
+  std::string_view s = record_;
+  std::size_t pos = pos_;
+  while (pos < s.size() && (is_ws(s[pos]) || s[pos] == ',')) ++pos;
+  if (pos >= s.size() || s[pos] == '}') {
+    done_ = true;
+    return false;
+  }
+
+  // Key.
+  if (s[pos] != '"') {
+    done_ = true;
+    return false;
+  }
+  std::size_t key_end = skip_string(s, pos);
+  if (key_end == std::string_view::npos) {
+    done_ = true;
+    return false;
+  }
+  std::string_view key = s.substr(pos + 1, key_end - pos - 2);
+  pos = key_end;
+
+  while (pos < s.size() && is_ws(s[pos])) ++pos;
+  if (pos >= s.size() || s[pos] != ':') {
+    done_ = true;
+    return false;
+  }
+  ++pos;
+  while (pos < s.size() && is_ws(s[pos])) ++pos;
+  if (pos >= s.size()) {
+    done_ = true;
+    return false;
+  }
+
+  // Value: record the raw slice; do not tokenize the contents.
+  std::size_t start = pos;
+  ValueType type;
+  switch (s[pos]) {
+    case '"':
+      type = ValueType::kString;
+      pos = skip_string(s, pos);
+      break;
+    case '{':
+      type = ValueType::kObject;
+      pos = skip_nested(s, pos, '{', '}');
+      break;
+    case '[':
+      type = ValueType::kArray;
+      pos = skip_nested(s, pos, '[', ']');
+      break;
+    case 't':
+    case 'f':
+      type = ValueType::kBool;
+      pos = skip_literal(s, pos);
+      break;
+    case 'n':
+      type = ValueType::kNull;
+      pos = skip_literal(s, pos);
+      break;
+    default:
+      type = ValueType::kNumber;
+      pos = skip_literal(s, pos);
+      break;
+  }
+  if (pos == std::string_view::npos) {
+    done_ = true;
+    return false;
+  }
+
+  append(Field{key, Value(type, s.substr(start, pos - start))});
+  pos_ = pos;
+  return true;
+}
+
+}  // namespace jsonl
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "parse/arena.h"
+
+namespace jsonl {
+
+class InternTable;
+
+enum class ValueType : std::uint8_t {
+  kMissing,  // key not present in the record
+  kNull,
+  kBool,
+  kNumber,
+  kString,
+  kObject,
+  kArray,
+};
+
+// View of one JSON value inside a record. Holds the raw text slice; numeric
+// and boolean conversions happen on demand and only for values the caller
+// actually asks for.
+class Value {
+ public:
+  Value() = default;
+  Value(ValueType type, std::string_view raw) : type_(type), raw_(raw) {}
+
+  ValueType type() const noexcept { return type_; }
+  explicit operator bool() const noexcept {
+    return type_ != ValueType::kMissing;
+  }
+  bool is_null() const noexcept { return type_ == ValueType::kNull; }
+
+  // Raw text of the value, quotes and all.
+  std::string_view raw() const noexcept { return raw_; }
+
+  // String contents between the quotes, without unescaping. Records in our
+  // logs almost never contain escapes; callers that need full unescaping
+  // copy out explicitly.
+  std::string_view as_string(std::string_view dflt = {}) const noexcept;
+
+  // String contents with JSON escapes resolved. The common case — no
+  // backslash anywhere in the value — returns the same zero-copy slice as
+  // as_string(); only when an escape is present does it decode into a copy
+  // allocated from `arena` (\uXXXX pairs of surrogates included). Returns
+  // `dflt` for non-strings and for malformed escapes.
+  std::string_view as_string_unescaped(Arena& arena,
+                                       std::string_view dflt = {}) const;
+
+  // Interns the string contents and returns its dense symbol ID
+  // (InternTable::kNoSymbol for non-string values). After first sight of a
+  // value this is hash-probe plus integer compare, no allocation.
+  std::uint32_t as_symbol(InternTable& table) const;
+
+  std::int64_t as_int64(std::int64_t dflt = 0) const noexcept;
+  double as_double(double dflt = 0.0) const noexcept;
+  bool as_bool(bool dflt = false) const noexcept;
+
+  // Epoch milliseconds: numeric values pass through as-is, strings go
+  // through the ISO-8601 kernel (jsonl::parse_ts).
+  std::int64_t as_timestamp_ms(std::int64_t dflt = 0) const noexcept;
+
+ private:
+  ValueType type_ = ValueType::kMissing;
+  std::string_view raw_;
+};
+
+// Lazily parsed view of one JSONL record (a top-level JSON object).
+//
+// Nothing is parsed at construction. The first key lookup scans the object
+// only as far as the requested key, recording each (key, raw value) pair it
+// passes in an arena-backed field table; later lookups hit the table or
+// resume the scan where it stopped. A job touching 2-3 of 40 fields never
+// tokenizes the other 37 values beyond skipping over them.
+//
+// All nodes live in the caller-supplied Arena; documents hold no owned
+// memory and are cheap to create per record. Reset the arena between
+// batches, not between records.
+class LazyDocument {
+ public:
+  LazyDocument(std::string_view record, Arena& arena);
+
+  // Looks up a top-level key. Returns a kMissing value if absent or if the
+  // record is not a well-formed object up to the point of the key.
+  Value operator[](std::string_view key);
+
+  // Number of top-level fields scanned past so far.
+  std::size_t fields_seen() const noexcept { return size_; }
+
+  // Positional lookup for generated accessors (see schema_inference):
+  // parses forward until `index` fields are cached and verifies the key.
+  // Falls back to a name lookup when the producer emitted fields in a
+  // different order, so positional access is a fast path, not a contract.
+  Value field_at(std::size_t index, std::string_view expected_key);
+
+  // Parses the remaining fields and returns the total count; pair with
+  // key_at/value_at to visit every field (schema inference does).
+  std::size_t parse_all();
+  std::string_view key_at(std::size_t i) const noexcept {
+    return fields_[i].key;
+  }
+  Value value_at(std::size_t i) const noexcept { return fields_[i].value; }
+
+  // Parses an embedded object value as its own lazy document.
+  LazyDocument descend(const Value& v) const {
+    return LazyDocument(v.raw(), *arena_);
+  }
+
+ private:
+  struct Field {
+    std::string_view key;
+    Value value;
+  };
+
+  // Parses the next key/value pair into the field table. Returns false when
+  // the object is exhausted or malformed.
+  bool advance();
+  void append(const Field& f);
+
+  std::string_view record_;
+  Arena* arena_;
+  Field* fields_ = nullptr;
+  std::size_t size_ = 0;
+  std::size_t capacity_ = 0;
+  std::size_t pos_ = 0;  // scan position within record_
+  bool done_ = false;
+};
+
+}  // namespace jsonl
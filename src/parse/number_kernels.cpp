@@ -0,0 +1,223 @@
+#include "parse/number_kernels.h"
+
+#include <charconv>
+#include <cstring>
+
+namespace jsonl {
+
+namespace {
+
+inline bool is_digit(char c) noexcept { return c >= '0' && c <= '9'; }
+
+// True when all eight bytes of `chunk` are ASCII digits.
+inline bool all_digits8(std::uint64_t chunk) noexcept {
+  return ((chunk & 0xf0f0f0f0f0f0f0f0ull) |
+          (((chunk + 0x0606060606060606ull) & 0xf0f0f0f0f0f0f0f0ull) >> 4)) ==
+         0x3333333333333333ull;
+}
+
+// Converts eight ASCII digits (first digit in the lowest byte) to their
+// numeric value with three multiply-shift steps.
+inline std::uint64_t digits8_value(std::uint64_t chunk) noexcept {
+  chunk = (chunk & 0x0f0f0f0f0f0f0f0full) * 2561 >> 8;
+  chunk = (chunk & 0x00ff00ff00ff00ffull) * 6553601 >> 16;
+  return (chunk & 0x0000ffff0000ffffull) * 42949672960001ull >> 32;
+}
+
+inline std::uint64_t load8(const char* p) noexcept {
+  std::uint64_t chunk;
+  std::memcpy(&chunk, p, sizeof(chunk));
+  return chunk;
+}
+
+// Parses a run of digits into `value`; returns digits consumed, stopping
+// at the first non-digit. `value` saturates silently past 19 digits — the
+// callers reject such inputs by digit count.
+std::size_t parse_digits(const char* p, const char* end,
+                         std::uint64_t& value) noexcept {
+  const char* start = p;
+  while (end - p >= 8) {
+    const std::uint64_t chunk = load8(p);
+    if (!all_digits8(chunk)) break;
+    value = value * 100000000 + digits8_value(chunk);
+    p += 8;
+  }
+  while (p < end && is_digit(*p)) {
+    value = value * 10 + static_cast<std::uint64_t>(*p - '0');
+    ++p;
+  }
+  return static_cast<std::size_t>(p - start);
+}
+
+// Exact powers of ten up to 10^22 (the largest exactly representable).
+constexpr double kPow10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+}  // namespace
+
+bool parse_int(std::string_view s, std::int64_t& out) noexcept {
+  const char* p = s.data();
+  const char* end = p + s.size();
+  bool negative = false;
+  if (p < end && *p == '-') {
+    negative = true;
+    ++p;
+  }
+  if (p == end) return false;
+
+  std::uint64_t value = 0;
+  const std::size_t digits = parse_digits(p, end, value);
+  if (digits == 0 || p + digits != end) return false;
+  if (digits > 19) return false;  // would have wrapped
+  if (digits == 19) {
+    // 19-digit values can exceed the int64 range; re-check precisely.
+    const std::uint64_t limit =
+        negative ? 0x8000000000000000ull : 0x7fffffffffffffffull;
+    if (value > limit) return false;
+  }
+  // Negate in the unsigned domain: value == 2^63 (INT64_MIN's magnitude)
+  // cannot be negated as a signed quantity.
+  out = negative ? static_cast<std::int64_t>(0 - value)
+                 : static_cast<std::int64_t>(value);
+  return true;
+}
+
+bool parse_float(std::string_view s, double& out) noexcept {
+  const char* p = s.data();
+  const char* end = p + s.size();
+  bool negative = false;
+  if (p < end && *p == '-') {
+    negative = true;
+    ++p;
+  }
+  if (p == end || !is_digit(*p)) return false;
+
+  std::uint64_t mantissa = 0;
+  std::size_t int_digits = parse_digits(p, end, mantissa);
+  p += int_digits;
+
+  int exponent = 0;
+  std::size_t frac_digits = 0;
+  if (p < end && *p == '.') {
+    ++p;
+    frac_digits = parse_digits(p, end, mantissa);
+    if (frac_digits == 0) return false;
+    p += frac_digits;
+    exponent -= static_cast<int>(frac_digits);
+  }
+  if (p < end && (*p == 'e' || *p == 'E')) {
+    ++p;
+    bool exp_negative = false;
+    if (p < end && (*p == '+' || *p == '-')) {
+      exp_negative = *p == '-';
+      ++p;
+    }
+    std::uint64_t e = 0;
+    const std::size_t exp_len = parse_digits(p, end, e);
+    if (exp_len == 0 || exp_len > 3) return false;
+    p += exp_len;
+    exponent += exp_negative ? -static_cast<int>(e) : static_cast<int>(e);
+  }
+  if (p != end) return false;
+
+  // Fast path: both mantissa and 10^|exponent| exact in a double, so one
+  // rounding step gives the correctly rounded result. Mantissas at or
+  // above 2^53 are not exact in a double (the cast itself rounds, then
+  // the multiply rounds again), so they take the slow path; the digit
+  // bound keeps parse_digits' silent wrap out of play.
+  if (int_digits + frac_digits <= 19 && mantissa < (1ull << 53) &&
+      exponent >= -22 && exponent <= 22) {
+    double value = static_cast<double>(mantissa);
+    value = exponent >= 0 ? value * kPow10[exponent]
+                          : value / kPow10[-exponent];
+    out = negative ? -value : value;
+    return true;
+  }
+
+  // Hard cases (long mantissas, large exponents): defer to from_chars.
+  auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), out);
+  return ec == std::errc() && ptr == s.data() + s.size();
+}
+
+bool parse_ts(std::string_view s, std::int64_t& epoch_ms) noexcept {
+  // Minimum shape: "YYYY-MM-DDTHH:MM:SS" (19 bytes).
+  if (s.size() < 19) return false;
+  const char* p = s.data();
+  if (p[4] != '-' || p[7] != '-' || (p[10] != 'T' && p[10] != ' ') ||
+      p[13] != ':' || p[16] != ':') {
+    return false;
+  }
+  for (int i : {0, 1, 2, 3, 5, 6, 8, 9, 11, 12, 14, 15, 17, 18}) {
+    if (!is_digit(p[i])) return false;
+  }
+
+  const int year = (p[0] - '0') * 1000 + (p[1] - '0') * 100 +
+                   (p[2] - '0') * 10 + (p[3] - '0');
+  const int month = (p[5] - '0') * 10 + (p[6] - '0');
+  const int day = (p[8] - '0') * 10 + (p[9] - '0');
+  const int hour = (p[11] - '0') * 10 + (p[12] - '0');
+  const int minute = (p[14] - '0') * 10 + (p[15] - '0');
+  const int second = (p[17] - '0') * 10 + (p[18] - '0');
+  if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 ||
+      minute > 59 || second > 60) {
+    return false;
+  }
+
+  std::size_t at = 19;
+  std::int64_t millis = 0;
+  if (at < s.size() && s[at] == '.') {
+    ++at;
+    // Take up to millisecond precision; skip any finer digits.
+    int scale = 100;
+    std::size_t digits = 0;
+    while (at < s.size() && is_digit(s[at])) {
+      if (digits < 3) {
+        millis += (s[at] - '0') * scale;
+        scale /= 10;
+      }
+      ++digits;
+      ++at;
+    }
+    if (digits == 0) return false;
+  }
+
+  std::int64_t offset_s = 0;
+  if (at < s.size()) {
+    const char c = s[at];
+    if (c == 'Z') {
+      ++at;
+    } else if (c == '+' || c == '-') {
+      if (s.size() - at != 6 || s[at + 3] != ':' || !is_digit(s[at + 1]) ||
+          !is_digit(s[at + 2]) || !is_digit(s[at + 4]) ||
+          !is_digit(s[at + 5])) {
+        return false;
+      }
+      const int oh = (s[at + 1] - '0') * 10 + (s[at + 2] - '0');
+      const int om = (s[at + 4] - '0') * 10 + (s[at + 5] - '0');
+      offset_s = (oh * 60 + om) * 60;
+      if (c == '+') offset_s = -offset_s;  // ahead of UTC -> subtract
+      at += 6;
+    }
+  }
+  if (at != s.size()) return false;
+
+  // Days from civil date (Howard Hinnant's algorithm), epoch 1970-01-01.
+  const int y = year - (month <= 2);
+  const int era = (y >= 0 ? y : y - 399) / 400;
+  const unsigned yoe = static_cast<unsigned>(y - era * 400);
+  const unsigned doy =
+      (153u * static_cast<unsigned>(month + (month > 2 ? -3 : 9)) + 2) / 5 +
+      static_cast<unsigned>(day) - 1;
+  const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  const std::int64_t days =
+      static_cast<std::int64_t>(era) * 146097 +
+      static_cast<std::int64_t>(doe) - 719468;
+
+  const std::int64_t seconds =
+      days * 86400 + hour * 3600 + minute * 60 + second + offset_s;
+  epoch_ms = seconds * 1000 + millis;
+  return true;
+}
+
+}  // namespace jsonl
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace jsonl {
+
+// Branch-light text-to-number kernels for the conversion hot path.
+//
+// strtod/sscanf dominate conversion-heavy jobs; these kernels replace them
+// on the shapes our logs actually contain. All functions parse the entire
+// input (no trailing junk), return false on malformed text and leave `out`
+// unspecified on failure.
+
+// Decimal integer with optional leading '-'. Digits are consumed eight at
+// a time with SWAR multiply-shift reduction, so a typical latency_ms value
+// costs two 64-bit multiplies instead of a per-digit loop.
+bool parse_int(std::string_view s, std::int64_t& out) noexcept;
+
+// JSON-style float. Mantissas below 2^53 with decimal exponents in
+// [-22, 22] take an exact fast path (mantissa and power of ten are both
+// exactly representable, one multiply/divide rounds correctly); everything
+// else falls back to std::from_chars. The fast path covers effectively all
+// numeric fields in request logs.
+bool parse_float(std::string_view s, double& out) noexcept;
+
+// ISO-8601 timestamp ("2024-01-02T03:04:05.678Z", offset suffixes
+// "+HH:MM"/"-HH:MM" accepted, fractional seconds optional) to epoch
+// milliseconds. Fixed-position digit extraction plus the days-from-civil
+// formula — no strptime, no table lookups of month names, no allocation.
+bool parse_ts(std::string_view s, std::int64_t& epoch_ms) noexcept;
+
+}  // namespace jsonl
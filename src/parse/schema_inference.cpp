@@ -0,0 +1,239 @@
+#include "parse/schema_inference.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <unordered_map>
+
+#include "parse/arena.h"
+#include "parse/lazy_document.h"
+#include "parse/number_kernels.h"
+
+namespace jsonl {
+
+namespace {
+
+constexpr std::size_t kArenaBatch = 4096;
+
+struct FieldObservations {
+  std::uint64_t present = 0;
+  std::uint64_t nulls = 0;
+  std::uint64_t bools = 0;
+  std::uint64_t ints = 0;
+  std::uint64_t floats = 0;
+  std::uint64_t timestamps = 0;  // strings parsing as ISO-8601
+  std::uint64_t strings = 0;     // strings that do not
+  std::uint64_t structured = 0;  // objects and arrays
+  std::map<std::size_t, std::uint64_t> positions;
+};
+
+bool looks_float(std::string_view raw) noexcept {
+  return raw.find_first_of(".eE") != std::string_view::npos;
+}
+
+SchemaType resolve_type(const FieldObservations& o) noexcept {
+  const std::uint64_t typed = o.bools + o.ints + o.floats + o.timestamps +
+                              o.strings + o.structured;
+  if (typed == 0) return SchemaType::kRaw;  // only nulls seen
+  if (o.structured != 0) return SchemaType::kRaw;
+  if (o.bools == typed) return SchemaType::kBool;
+  if (o.ints == typed) return SchemaType::kInt64;
+  if (o.ints + o.floats == typed) return SchemaType::kFloat64;
+  if (o.timestamps == typed) return SchemaType::kTimestampMs;
+  if (o.timestamps + o.strings == typed) return SchemaType::kString;
+  // Numbers or bools mixed with strings: widen to string if every value
+  // at least has a printable form, otherwise raw.
+  if (o.bools == 0 && o.ints == 0 && o.floats == 0) return SchemaType::kString;
+  return SchemaType::kRaw;
+}
+
+std::string identifier_for(std::string_view name) {
+  std::string id;
+  id.reserve(name.size());
+  for (char c : name) {
+    id.push_back(std::isalnum(static_cast<unsigned char>(c)) ? c : '_');
+  }
+  if (id.empty() || std::isdigit(static_cast<unsigned char>(id[0]))) {
+    id.insert(id.begin(), 'f');
+  }
+  return id;
+}
+
+// Field names come from arbitrary JSON keys; splicing them into the
+// generated source verbatim breaks the header on a quote or backslash
+// (and is an injection vector). Quotes, backslashes and non-printable
+// bytes are escaped; octal is used for the latter because it cannot
+// swallow a following literal character the way \x can.
+std::string cstring_literal(std::string_view s) {
+  std::string out;
+  out.reserve(s.size() + 2);
+  for (char c : s) {
+    const unsigned char u = static_cast<unsigned char>(c);
+    if (c == '"' || c == '\\') {
+      out.push_back('\\');
+      out.push_back(c);
+    } else if (u < 0x20 || u >= 0x7f) {
+      char esc[8];
+      std::snprintf(esc, sizeof(esc), "\\%03o", u);
+      out += esc;
+    } else {
+      out.push_back(c);
+    }
+  }
+  return out;
+}
+
+}  // namespace
+
+Schema infer_schema(std::string_view log_bytes, std::size_t sample_records) {
+  std::unordered_map<std::string, FieldObservations> observed;
+  Arena arena;
+  std::uint64_t records = 0;
+
+  std::size_t pos = 0;
+  while (records < sample_records && pos < log_bytes.size()) {
+    const char* nl = static_cast<const char*>(std::memchr(
+        log_bytes.data() + pos, '\n', log_bytes.size() - pos));
+    if (nl == nullptr) break;  // torn tail: not a complete sample
+    const std::string_view record =
+        log_bytes.substr(pos, static_cast<std::size_t>(
+                                  nl - log_bytes.data()) - pos);
+    pos += record.size() + 1;
+
+    LazyDocument doc(record, arena);
+    const std::size_t n = doc.parse_all();
+    for (std::size_t i = 0; i < n; ++i) {
+      FieldObservations& o = observed[std::string(doc.key_at(i))];
+      ++o.present;
+      ++o.positions[i];
+      const Value v = doc.value_at(i);
+      switch (v.type()) {
+        case ValueType::kNull:
+          ++o.nulls;
+          break;
+        case ValueType::kBool:
+          ++o.bools;
+          break;
+        case ValueType::kNumber:
+          looks_float(v.raw()) ? ++o.floats : ++o.ints;
+          break;
+        case ValueType::kString: {
+          std::int64_t ms;
+          parse_ts(v.as_string(), ms) ? ++o.timestamps : ++o.strings;
+          break;
+        }
+        case ValueType::kObject:
+        case ValueType::kArray:
+          ++o.structured;
+          break;
+        case ValueType::kMissing:
+          break;
+      }
+    }
+    ++records;
+    if (records % kArenaBatch == 0) arena.reset();
+  }
+
+  Schema schema;
+  schema.sampled_records = records;
+  schema.fields.reserve(observed.size());
+  for (const auto& [name, o] : observed) {
+    SchemaField f;
+    f.name = name;
+    f.type = resolve_type(o);
+    f.presence =
+        records == 0 ? 0.0
+                     : static_cast<double>(o.present) /
+                           static_cast<double>(records);
+    f.nullable = o.nulls != 0;
+    std::uint64_t best = 0;
+    for (const auto& [position, count] : o.positions) {
+      if (count > best) {
+        best = count;
+        f.position = position;
+      }
+    }
+    schema.fields.push_back(std::move(f));
+  }
+  std::sort(schema.fields.begin(), schema.fields.end(),
+            [](const SchemaField& a, const SchemaField& b) {
+              return a.position != b.position ? a.position < b.position
+                                              : a.name < b.name;
+            });
+  return schema;
+}
+
+std::string generate_accessor_header(const Schema& schema,
+                                     const std::string& struct_name,
+                                     const std::string& source_name) {
+  std::string out;
+  out.reserve(2048);
+  auto emit = [&out](std::string_view s) { out.append(s); };
+
+  emit("// Generated by jlschema from " + source_name + " (" +
+       std::to_string(schema.sampled_records) +
+       " records sampled). Do not edit.\n");
+  emit("#pragma once\n\n");
+  emit("#include <cstdint>\n");
+  emit("#include <string_view>\n\n");
+  emit("#include \"parse/arena.h\"\n");
+  emit("#include \"parse/lazy_document.h\"\n\n");
+  emit("struct " + struct_name + " {\n");
+  emit("  jsonl::LazyDocument doc;\n\n");
+  emit("  " + struct_name +
+       "(std::string_view record, jsonl::Arena& arena)\n"
+       "      : doc(record, arena) {}\n");
+
+  char line[160];
+  std::unordered_map<std::string, unsigned> used_ids;
+  for (const SchemaField& f : schema.fields) {
+    // Distinct keys can sanitize to the same identifier ("a.b" and
+    // "a_b"); suffix repeats so the struct still compiles.
+    std::string id = identifier_for(f.name);
+    const unsigned seen = used_ids[id]++;
+    if (seen != 0) id += "_" + std::to_string(seen + 1);
+    std::snprintf(line, sizeof(line),
+                  "\n  // position %zu, present in %.1f%% of samples%s\n",
+                  f.position, f.presence * 100.0,
+                  f.nullable ? ", nullable" : "");
+    emit(line);
+    const std::string at = "doc.field_at(" + std::to_string(f.position) +
+                           ", \"" + cstring_literal(f.name) + "\")";
+    switch (f.type) {
+      case SchemaType::kBool:
+        emit("  bool " + id + "(bool dflt = false) { return " + at +
+             ".as_bool(dflt); }\n");
+        break;
+      case SchemaType::kInt64:
+        emit("  std::int64_t " + id + "(std::int64_t dflt = 0) { return " +
+             at + ".as_int64(dflt); }\n");
+        break;
+      case SchemaType::kFloat64:
+        emit("  double " + id + "(double dflt = 0.0) { return " + at +
+             ".as_double(dflt); }\n");
+        break;
+      case SchemaType::kTimestampMs:
+        emit("  std::int64_t " + id +
+             "_ms(std::int64_t dflt = 0) { return " + at +
+             ".as_timestamp_ms(dflt); }\n");
+        break;
+      case SchemaType::kString:
+        emit("  std::string_view " + id +
+             "(std::string_view dflt = {}) { return " + at +
+             ".as_string(dflt); }\n");
+        break;
+      case SchemaType::kRaw:
+        emit("  std::string_view " + id + "_raw() { return " + at +
+             ".raw(); }\n");
+        break;
+    }
+    emit("  bool has_" + id + "() { return static_cast<bool>(" + at +
+         "); }\n");
+  }
+  emit("};\n");
+  return out;
+}
+
+}  // namespace jsonl
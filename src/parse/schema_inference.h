@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace jsonl {
+
+// One-pass schema inference and typed-accessor codegen.
+//
+// Consumers hand-write field extraction and pay a dynamic-typed lookup
+// per access. infer_schema() samples the log once and records, per
+// top-level field: the concrete type (numbers split into int/float,
+// strings that parse as ISO-8601 promoted to timestamps), the position
+// the producer emits it at, how often it is present, and nullability.
+// generate_accessor_header() then emits a C++ header with one typed
+// accessor per field, each compiled down to LazyDocument::field_at —
+// positional access into the cached field table with a by-name fallback —
+// so hot loops do a bounds check and one key verify instead of a key
+// scan, while the JSONL file stays the source of truth.
+//
+// Mixed-type fields widen (int -> float -> string); fields that mix
+// scalars with objects/arrays degrade to a raw-slice accessor.
+
+enum class SchemaType : std::uint8_t {
+  kBool,
+  kInt64,
+  kFloat64,
+  kTimestampMs,  // string field whose sampled values all parse as ISO-8601
+  kString,
+  kRaw,  // mixed or structured (object/array) values; raw slice access
+};
+
+struct SchemaField {
+  std::string name;
+  SchemaType type = SchemaType::kRaw;
+  std::size_t position = 0;  // most common emit position across samples
+  double presence = 0.0;     // fraction of sampled records containing it
+  bool nullable = false;     // null was observed (missing shows in presence)
+};
+
+struct Schema {
+  std::vector<SchemaField> fields;  // ordered by position
+  std::uint64_t sampled_records = 0;
+};
+
+// Samples up to `sample_records` records from the start of `log_bytes`.
+Schema infer_schema(std::string_view log_bytes,
+                    std::size_t sample_records = 65536);
+
+// Emits a self-contained header defining `struct_name` with typed
+// accessors and has_<field>() presence checks. `source_name` only feeds
+// the generated banner comment.
+std::string generate_accessor_header(const Schema& schema,
+                                     const std::string& struct_name,
+                                     const std::string& source_name);
+
+}  // namespace jsonl
@@ -0,0 +1,98 @@
+#include "perf/scan_stats.h"
+
+#include <deque>
+#include <mutex>
+
+namespace jsonl {
+
+ScanStats ScanStats::operator-(const ScanStats& other) const noexcept {
+  ScanStats d;
+  d.bytes_scanned = bytes_scanned - other.bytes_scanned;
+  d.bytes_read = bytes_read - other.bytes_read;
+  d.bytes_written = bytes_written - other.bytes_written;
+  d.records_parsed = records_parsed - other.records_parsed;
+  d.records_emitted = records_emitted - other.records_emitted;
+  d.chunks_scanned = chunks_scanned - other.chunks_scanned;
+  d.chunks_skipped = chunks_skipped - other.chunks_skipped;
+  d.chunk_steals = chunk_steals - other.chunk_steals;
+  d.arena_block_bytes = arena_block_bytes - other.arena_block_bytes;
+  d.ring_full_waits = ring_full_waits - other.ring_full_waits;
+  d.batch_resizes = batch_resizes - other.batch_resizes;
+  d.stage_switches = stage_switches - other.stage_switches;
+  return d;
+}
+
+std::string ScanStats::to_json() const {
+  std::string out;
+  out.reserve(256);
+  out += '{';
+  auto field = [&](const char* name, std::uint64_t value) {
+    if (out.size() > 1) out += ", ";
+    out += '"';
+    out += name;
+    out += "\": ";
+    out += std::to_string(value);
+  };
+  field("bytes_scanned", bytes_scanned);
+  field("bytes_read", bytes_read);
+  field("bytes_written", bytes_written);
+  field("records_parsed", records_parsed);
+  field("records_emitted", records_emitted);
+  field("chunks_scanned", chunks_scanned);
+  field("chunks_skipped", chunks_skipped);
+  field("chunk_steals", chunk_steals);
+  field("arena_block_bytes", arena_block_bytes);
+  field("ring_full_waits", ring_full_waits);
+  field("batch_resizes", batch_resizes);
+  field("stage_switches", stage_switches);
+  out += '}';
+  return out;
+}
+
+namespace perf {
+
+namespace {
+
+// deque: stable addresses, so a thread's pointer outlives registration of
+// later threads. Blocks are never removed — an exited worker's totals stay
+// part of the snapshot.
+std::mutex g_registry_mutex;
+std::deque<ThreadCounters>& registry() {
+  static std::deque<ThreadCounters> r;
+  return r;
+}
+
+}  // namespace
+
+ThreadCounters& counters() noexcept {
+  thread_local ThreadCounters* block = [] {
+    std::lock_guard lock(g_registry_mutex);
+    return &registry().emplace_back();
+  }();
+  return *block;
+}
+
+ScanStats snapshot() noexcept {
+  ScanStats s;
+  std::lock_guard lock(g_registry_mutex);
+  for (const ThreadCounters& c : registry()) {
+    s.bytes_scanned += c.bytes_scanned.load(std::memory_order_relaxed);
+    s.bytes_read += c.bytes_read.load(std::memory_order_relaxed);
+    s.bytes_written += c.bytes_written.load(std::memory_order_relaxed);
+    s.records_parsed += c.records_parsed.load(std::memory_order_relaxed);
+    s.records_emitted += c.records_emitted.load(std::memory_order_relaxed);
+    s.chunks_scanned += c.chunks_scanned.load(std::memory_order_relaxed);
+    s.chunks_skipped += c.chunks_skipped.load(std::memory_order_relaxed);
+    s.chunk_steals += c.chunk_steals.load(std::memory_order_relaxed);
+    s.arena_block_bytes +=
+        c.arena_block_bytes.load(std::memory_order_relaxed);
+    s.ring_full_waits += c.ring_full_waits.load(std::memory_order_relaxed);
+    s.batch_resizes += c.batch_resizes.load(std::memory_order_relaxed);
+    s.stage_switches += c.stage_switches.load(std::memory_order_relaxed);
+  }
+  return s;
+}
+
+}  // namespace perf
+
+}  // namespace jsonl
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace jsonl {
+
+// Aggregated snapshot of the pipeline's stage counters; the answer to
+// "where did the nightly scan spend its time" without an strace session.
+// Produce one with perf::snapshot(), diff two with operator-, print with
+// to_json().
+struct ScanStats {
+  std::uint64_t bytes_scanned = 0;     // record bytes walked by scan workers
+  std::uint64_t bytes_read = 0;        // bytes fetched by io backends
+  std::uint64_t bytes_written = 0;     // bytes committed by LogWriter
+  std::uint64_t records_parsed = 0;    // LazyDocument constructions
+  std::uint64_t records_emitted = 0;   // records delivered to callbacks
+  std::uint64_t chunks_scanned = 0;
+  std::uint64_t chunks_skipped = 0;    // rejected by a ChunkPredicate
+  std::uint64_t chunk_steals = 0;      // work-stealing rebalances
+  std::uint64_t arena_block_bytes = 0; // fresh blocks chained by arenas
+  std::uint64_t ring_full_waits = 0;   // producer stalls on a full ring
+  std::uint64_t batch_resizes = 0;     // adaptive batch-size adjustments
+  std::uint64_t stage_switches = 0;    // pipeline workers changing stage
+
+  ScanStats operator-(const ScanStats& other) const noexcept;
+
+  // One JSON object, field names as above.
+  std::string to_json() const;
+};
+
+namespace perf {
+
+// Per-thread counter block. Each thread increments only its own block
+// (relaxed stores to warm cache lines — a nanosecond per bump, paid
+// whether or not anyone ever snapshots), so hot paths never share a
+// counter line. Blocks live for the process so snapshot() stays valid
+// after worker threads exit.
+struct alignas(64) ThreadCounters {
+  std::atomic<std::uint64_t> bytes_scanned{0};
+  std::atomic<std::uint64_t> bytes_read{0};
+  std::atomic<std::uint64_t> bytes_written{0};
+  std::atomic<std::uint64_t> records_parsed{0};
+  std::atomic<std::uint64_t> records_emitted{0};
+  std::atomic<std::uint64_t> chunks_scanned{0};
+  std::atomic<std::uint64_t> chunks_skipped{0};
+  std::atomic<std::uint64_t> chunk_steals{0};
+  std::atomic<std::uint64_t> arena_block_bytes{0};
+  std::atomic<std::uint64_t> ring_full_waits{0};
+  std::atomic<std::uint64_t> batch_resizes{0};
+  std::atomic<std::uint64_t> stage_switches{0};
+
+  void add(std::atomic<std::uint64_t> ThreadCounters::* field,
+           std::uint64_t n) noexcept {
+    (this->*field).fetch_add(n, std::memory_order_relaxed);
+  }
+};
+
+// The calling thread's counter block (registered on first use). Hot loops
+// should hoist the reference out of the loop body.
+ThreadCounters& counters() noexcept;
+
+// Sums every thread's block, including threads that have exited.
+ScanStats snapshot() noexcept;
+
+}  // namespace perf
+
+}  // namespace jsonl
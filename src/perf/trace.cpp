@@ -0,0 +1,147 @@
+#include "perf/trace.h"
+
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <system_error>
+
+namespace jsonl {
+namespace perf {
+
+namespace trace_detail {
+std::atomic<bool> g_enabled{false};
+}  // namespace trace_detail
+
+namespace {
+
+struct TraceEvent {
+  const char* name;
+  std::int64_t begin_ns;
+  std::int64_t end_ns;
+};
+
+// 64Ki events per thread: at batch granularity that is hours of spans,
+// and a full ring only costs the oldest events, never a stall.
+constexpr std::uint64_t kRingEvents = 1 << 16;
+
+// Single-writer ring. head only grows; the slot is head masked down, so
+// a wrapped ring holds the newest kRingEvents spans and the surplus is
+// reported as dropped.
+struct TraceRing {
+  std::uint32_t tid = 0;
+  std::atomic<std::uint64_t> head{0};
+  TraceEvent events[kRingEvents];
+};
+
+// Same registry shape as the counter blocks: stable addresses, rings
+// outlive their threads so a late export still sees early workers.
+std::mutex g_registry_mutex;
+std::deque<TraceRing>& registry() {
+  static std::deque<TraceRing> r;
+  return r;
+}
+
+TraceRing& ring() noexcept {
+  thread_local TraceRing* r = [] {
+    std::lock_guard lock(g_registry_mutex);
+    TraceRing& fresh = registry().emplace_back();
+    fresh.tid = static_cast<std::uint32_t>(registry().size());
+    return &fresh;
+  }();
+  return *r;
+}
+
+}  // namespace
+
+namespace trace_detail {
+
+void record(const char* name, std::int64_t begin_ns) noexcept {
+  TraceRing& r = ring();
+  const std::uint64_t at = r.head.load(std::memory_order_relaxed);
+  TraceEvent& e = r.events[at & (kRingEvents - 1)];
+  e.name = name;
+  e.begin_ns = begin_ns;
+  e.end_ns = trace_clock_ns();
+  r.head.store(at + 1, std::memory_order_release);
+}
+
+}  // namespace trace_detail
+
+std::int64_t trace_clock_ns() noexcept {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void enable_trace() noexcept {
+  std::lock_guard lock(g_registry_mutex);
+  for (TraceRing& r : registry()) {
+    r.head.store(0, std::memory_order_relaxed);
+  }
+  trace_detail::g_enabled.store(true, std::memory_order_relaxed);
+}
+
+void disable_trace() noexcept {
+  trace_detail::g_enabled.store(false, std::memory_order_relaxed);
+}
+
+std::string trace_to_json() {
+  const int pid = static_cast<int>(::getpid());
+  std::string out;
+  out.reserve(1 << 20);
+  out += "{\"traceEvents\": [";
+  bool first = true;
+  std::uint64_t dropped = 0;
+
+  std::lock_guard lock(g_registry_mutex);
+  for (TraceRing& r : registry()) {
+    const std::uint64_t head = r.head.load(std::memory_order_acquire);
+    if (head == 0) continue;
+
+    char buf[192];
+    int n = std::snprintf(buf, sizeof(buf),
+                          "%s{\"name\": \"thread_name\", \"ph\": \"M\", "
+                          "\"pid\": %d, \"tid\": %u, "
+                          "\"args\": {\"name\": \"worker-%u\"}}",
+                          first ? "" : ", ", pid, r.tid, r.tid);
+    out.append(buf, n);
+    first = false;
+
+    const std::uint64_t count = head < kRingEvents ? head : kRingEvents;
+    dropped += head - count;
+    for (std::uint64_t i = head - count; i < head; ++i) {
+      const TraceEvent& e = r.events[i & (kRingEvents - 1)];
+      n = std::snprintf(buf, sizeof(buf),
+                        ", {\"name\": \"%s\", \"ph\": \"X\", "
+                        "\"pid\": %d, \"tid\": %u, "
+                        "\"ts\": %.3f, \"dur\": %.3f}",
+                        e.name, pid, r.tid,
+                        static_cast<double>(e.begin_ns) / 1e3,
+                        static_cast<double>(e.end_ns - e.begin_ns) / 1e3);
+      out.append(buf, n);
+    }
+  }
+  out += "], \"events_dropped\": ";
+  out += std::to_string(dropped);
+  out += "}\n";
+  return out;
+}
+
+void write_trace(const std::string& path) {
+  const std::string json = trace_to_json();
+  std::FILE* f = std::fopen(path.c_str(), "wb");
+  if (f == nullptr) {
+    throw std::system_error(errno, std::generic_category(), "open " + path);
+  }
+  const bool ok = std::fwrite(json.data(), 1, json.size(), f) == json.size();
+  if (std::fclose(f) != 0 || !ok) {
+    throw std::system_error(EIO, std::generic_category(), "write " + path);
+  }
+}
+
+}  // namespace perf
+}  // namespace jsonl
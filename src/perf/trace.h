@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace jsonl {
+namespace perf {
+
+// Sampling trace mode: begin/end spans from every pipeline stage, cheap
+// enough to leave on for a production run.
+//
+// Each thread writes fixed-size events into its own lock-free ring (the
+// same registration pattern as ThreadCounters), so recording a span is a
+// clock read and a 32-byte store with no shared writes; when the ring
+// wraps, the oldest events are overwritten and counted as dropped. With
+// tracing disabled a TraceSpan costs one relaxed load. Stages emit spans
+// at chunk/batch granularity, not per record — that is what keeps the
+// overhead of a traced run in the noise.
+//
+// write_trace() flushes every ring to Chrome trace-event JSON (loadable
+// in chrome://tracing and Perfetto), one track per recording thread.
+// Call it after worker threads have quiesced; rings are single-writer
+// and the exporter does not fence against in-flight spans.
+
+namespace trace_detail {
+extern std::atomic<bool> g_enabled;
+void record(const char* name, std::int64_t begin_ns) noexcept;
+}  // namespace trace_detail
+
+inline bool trace_enabled() noexcept {
+  return trace_detail::g_enabled.load(std::memory_order_relaxed);
+}
+
+// Starts recording. Rings are rewound, so a trace covers exactly the
+// window between enable and export.
+void enable_trace() noexcept;
+void disable_trace() noexcept;
+
+// Timestamp on the trace clock, for callers that want to correlate their
+// own logging with trace spans.
+std::int64_t trace_clock_ns() noexcept;
+
+// RAII span: records [construction, destruction) under `name` when
+// tracing is enabled. `name` must be a string literal (the ring stores
+// the pointer).
+class TraceSpan {
+ public:
+  explicit TraceSpan(const char* name) noexcept {
+    if (trace_enabled()) {
+      name_ = name;
+      begin_ns_ = trace_clock_ns();
+    }
+  }
+  ~TraceSpan() {
+    if (name_ != nullptr) trace_detail::record(name_, begin_ns_);
+  }
+
+  TraceSpan(const TraceSpan&) = delete;
+  TraceSpan& operator=(const TraceSpan&) = delete;
+
+ private:
+  const char* name_ = nullptr;
+  std::int64_t begin_ns_ = 0;
+};
+
+// Serializes every thread's ring as a Chrome trace-event JSON document.
+std::string trace_to_json();
+
+// trace_to_json() to a file. Throws std::system_error on I/O failure.
+void write_trace(const std::string& path);
+
+}  // namespace perf
+}  // namespace jsonl
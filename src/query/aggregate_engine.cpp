@@ -0,0 +1,127 @@
+#include "query/aggregate_engine.h"
+
+#include <memory>
+#include <string_view>
+
+#include "parse/lazy_document.h"
+#include "query/group_stats.h"
+
+namespace jsonl {
+
+namespace {
+
+using query_detail::Group;
+using query_detail::GroupTable;
+
+// Field-type specialization happens here: the scan loop is instantiated
+// once per extractor type, so per-record extraction is a direct call.
+struct Int64Extractor {
+  static double get(Value v) noexcept {
+    return static_cast<double>(v.as_int64());
+  }
+};
+struct Float64Extractor {
+  static double get(Value v) noexcept { return v.as_double(); }
+};
+
+constexpr std::size_t kArenaBatch = 4096;
+
+template <typename Extractor>
+void scan_groups(const AggregateQuery& query, const MappedReader& reader,
+                 const ParallelScanner& scanner,
+                 const ParallelScanner::ChunkPredicate* keep,
+                 std::vector<GroupTable>& tables) {
+  const bool grouped = !query.group_by.empty();
+  const bool has_field = !query.field.empty();
+  const bool percentiles = has_field && query.want_percentiles;
+  const bool time_bounded = !query.time_field.empty();
+
+  struct WorkerState {
+    Arena arena;
+    std::size_t records = 0;
+  };
+  std::vector<WorkerState> states(tables.size());
+
+  const auto record_fn = [&](std::string_view record,
+                             std::uint64_t /*offset*/, unsigned worker) {
+    WorkerState& st = states[worker];
+    LazyDocument doc(record, st.arena);
+
+    if (time_bounded) {
+      const Value tv = doc[query.time_field];
+      const std::int64_t ts = tv.as_timestamp_ms(INT64_MIN);
+      if (!tv || ts < query.time_begin_ms || ts >= query.time_end_ms) {
+        if (++st.records % kArenaBatch == 0) st.arena.reset();
+        return;
+      }
+    }
+
+    std::string_view key;
+    if (grouped) key = doc[query.group_by].as_string();
+
+    // Transparent lookup would avoid the temporary string; the table is
+    // per-worker and keys repeat heavily, so the allocation only happens
+    // on first sight of each key.
+    GroupTable& table = tables[worker];
+    auto it = table.find(std::string(key));
+    if (it == table.end()) {
+      it = table.emplace(std::string(key), Group{}).first;
+    }
+    Group& g = it->second;
+    ++g.count;
+    if (has_field) {
+      const double v = Extractor::get(doc[query.field]);
+      g.sum += v;
+      if (v < g.min) g.min = v;
+      if (v > g.max) g.max = v;
+      if (percentiles) g.hist.record(v);
+    }
+
+    if (++st.records % kArenaBatch == 0) st.arena.reset();
+  };
+
+  if (keep != nullptr) {
+    scanner.scan(reader, *keep, record_fn);
+  } else {
+    scanner.scan(reader, record_fn);
+  }
+}
+
+std::vector<GroupResult> run_query(const AggregateQuery& query,
+                                   const MappedReader& reader,
+                                   const ParallelScanner& scanner,
+                                   const ParallelScanner::ChunkPredicate* keep) {
+  std::vector<GroupTable> tables(scanner.thread_count());
+
+  switch (query.field_type) {
+    case FieldType::kInt64:
+      scan_groups<Int64Extractor>(query, reader, scanner, keep, tables);
+      break;
+    case FieldType::kFloat64:
+      scan_groups<Float64Extractor>(query, reader, scanner, keep, tables);
+      break;
+  }
+
+  // Merge worker tables and finalize.
+  GroupTable merged;
+  for (GroupTable& t : tables) query_detail::merge_into(merged, t);
+  return query_detail::finalize(
+      merged, !query.field.empty() && query.want_percentiles);
+}
+
+}  // namespace
+
+std::vector<GroupResult> AggregateEngine::run(
+    const MappedReader& reader, const ParallelScanner& scanner) const {
+  return run_query(query_, reader, scanner, nullptr);
+}
+
+std::vector<GroupResult> AggregateEngine::run(
+    const MappedReader& reader, const ParallelScanner& scanner,
+    const ZoneMapIndex& zones) const {
+  const ParallelScanner::ChunkPredicate keep =
+      zones.chunk_predicate(query_.time_begin_ms, query_.time_end_ms);
+  return run_query(query_, reader, scanner, &keep);
+}
+
+}  // namespace jsonl
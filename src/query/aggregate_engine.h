@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "io/mapped_reader.h"
+#include "index/zone_map.h"
+#include "scan/parallel_scanner.h"
+
+namespace jsonl {
+
+// One-pass streaming rollups over a JSONL log.
+//
+// A query names an optional group-by key (a string field such as
+// "endpoint") and a numeric field to aggregate (count/sum/min/max plus
+// approximate p50/p99). The engine runs as a single fused
+// extract-and-aggregate pass on top of ParallelScanner: each worker lazily
+// parses only the two requested fields, accumulates into its own group
+// table, and tables are merged once at the end — no locks, virtual calls
+// or re-parsing in the hot loop. The numeric extractor is specialized at
+// query-setup time on the declared field type, so the per-record path is a
+// concrete template instantiation rather than a dynamic dispatch.
+//
+// Percentiles come from per-group log-linear histograms (64 major x 16
+// minor buckets), giving streaming p50/p99 within ~3% relative error in
+// constant memory per group.
+
+enum class FieldType : std::uint8_t {
+  kInt64,
+  kFloat64,
+};
+
+struct AggregateQuery {
+  std::string group_by;  // empty means one global group
+  std::string field;     // numeric field; may be empty for pure counts
+  FieldType field_type = FieldType::kInt64;
+  bool want_percentiles = true;
+
+  // Optional half-open time bound [time_begin_ms, time_end_ms) on
+  // `time_field` (numeric epoch milliseconds or ISO-8601 strings).
+  // Records outside the range — or missing the field while a bound is
+  // set — are excluded. Pair with a ZoneMapIndex to skip whole chunks.
+  std::string time_field;
+  std::int64_t time_begin_ms = INT64_MIN;
+  std::int64_t time_end_ms = INT64_MAX;
+};
+
+struct GroupResult {
+  std::string key;  // empty for the global group
+  std::uint64_t count = 0;
+  double sum = 0.0;
+  double min = 0.0;
+  double max = 0.0;
+  double p50 = 0.0;  // only filled when want_percentiles
+  double p99 = 0.0;
+};
+
+class AggregateEngine {
+ public:
+  explicit AggregateEngine(AggregateQuery query) : query_(std::move(query)) {}
+
+  // Runs the query over the whole file. Results are sorted by descending
+  // count. `scanner` controls parallelism and chunking.
+  std::vector<GroupResult> run(const MappedReader& reader,
+                               const ParallelScanner& scanner) const;
+
+  std::vector<GroupResult> run(const MappedReader& reader) const {
+    return run(reader, ParallelScanner());
+  }
+
+  // Time-bounded run with chunk pruning: chunks whose zone lies entirely
+  // outside [time_begin_ms, time_end_ms) are skipped before any of their
+  // bytes are touched. The per-record bound still applies inside kept
+  // chunks, so results match the unpruned run exactly.
+  std::vector<GroupResult> run(const MappedReader& reader,
+                               const ParallelScanner& scanner,
+                               const ZoneMapIndex& zones) const;
+
+ private:
+  AggregateQuery query_;
+};
+
+}  // namespace jsonl
@@ -0,0 +1,339 @@
+#include "query/filter_expr.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <stdexcept>
+#include <vector>
+
+#include "parse/number_kernels.h"
+
+namespace jsonl {
+
+namespace {
+
+enum class CmpOp { kEq, kNe, kLt, kLe, kGt, kGe };
+enum class LitKind { kNumber, kString, kBool, kNull };
+
+template <typename T>
+bool compare(CmpOp op, const T& a, const T& b) noexcept {
+  switch (op) {
+    case CmpOp::kEq: return a == b;
+    case CmpOp::kNe: return a != b;
+    case CmpOp::kLt: return a < b;
+    case CmpOp::kLe: return a <= b;
+    case CmpOp::kGt: return a > b;
+    case CmpOp::kGe: return a >= b;
+  }
+  return false;
+}
+
+}  // namespace
+
+struct FilterExpr::Node {
+  enum Kind { kAnd, kOr, kNot, kCmp } kind;
+
+  // kAnd/kOr children, kNot single child.
+  std::vector<std::unique_ptr<Node>> kids;
+
+  // kCmp payload.
+  std::string field;
+  CmpOp op = CmpOp::kEq;
+  LitKind lit = LitKind::kNull;
+  double num = 0.0;
+  std::string str;
+  bool boolean = false;
+
+  // Observed selectivity, updated with relaxed atomics during matches().
+  mutable std::atomic<std::uint64_t> evals{0};
+  mutable std::atomic<std::uint64_t> passes{0};
+
+  bool eval(LazyDocument& doc) const {
+    bool result = false;
+    switch (kind) {
+      case kAnd:
+        result = true;
+        for (const auto& k : kids) {
+          if (!k->eval(doc)) {
+            result = false;
+            break;
+          }
+        }
+        break;
+      case kOr:
+        result = false;
+        for (const auto& k : kids) {
+          if (k->eval(doc)) {
+            result = true;
+            break;
+          }
+        }
+        break;
+      case kNot:
+        result = !kids[0]->eval(doc);
+        break;
+      case kCmp: {
+        const Value v = doc[field];
+        if (!v) {
+          result = false;
+          break;
+        }
+        switch (lit) {
+          case LitKind::kNumber:
+            result = v.type() == ValueType::kNumber &&
+                     compare(op, v.as_double(), num);
+            break;
+          case LitKind::kString:
+            result = v.type() == ValueType::kString &&
+                     compare(op, v.as_string(), std::string_view(str));
+            break;
+          case LitKind::kBool:
+            result = v.type() == ValueType::kBool &&
+                     compare(op, v.as_bool(), boolean);
+            break;
+          case LitKind::kNull:
+            result = compare(op, v.is_null(), true);
+            break;
+        }
+        break;
+      }
+      default:
+        result = false;
+    }
+    evals.fetch_add(1, std::memory_order_relaxed);
+    passes.fetch_add(result ? 1 : 0, std::memory_order_relaxed);
+    return result;
+  }
+
+  double pass_rate() const noexcept {
+    const std::uint64_t e = evals.load(std::memory_order_relaxed);
+    if (e == 0) return 0.5;  // unknown: leave in written order
+    return static_cast<double>(passes.load(std::memory_order_relaxed)) /
+           static_cast<double>(e);
+  }
+
+  void reoptimize() {
+    for (auto& k : kids) k->reoptimize();
+    if (kind == kAnd) {
+      // Lowest pass rate first: reject as early as possible.
+      std::stable_sort(kids.begin(), kids.end(),
+                       [](const auto& a, const auto& b) {
+                         return a->pass_rate() < b->pass_rate();
+                       });
+    } else if (kind == kOr) {
+      // Highest pass rate first: accept as early as possible.
+      std::stable_sort(kids.begin(), kids.end(),
+                       [](const auto& a, const auto& b) {
+                         return a->pass_rate() > b->pass_rate();
+                       });
+    }
+  }
+};
+
+namespace {
+
+// Recursive-descent parser.
+class Parser {
+ public:
+  explicit Parser(std::string_view text) : text_(text) {}
+
+  std::unique_ptr<FilterExpr::Node> parse() {
+    auto node = parse_or();
+    skip_ws();
+    if (pos_ != text_.size()) fail("unexpected trailing input");
+    return node;
+  }
+
+ private:
+  using Node = FilterExpr::Node;
+
+  [[noreturn]] void fail(const std::string& why) const {
+    throw std::invalid_argument("filter: " + why + " at position " +
+                                std::to_string(pos_));
+  }
+
+  void skip_ws() {
+    while (pos_ < text_.size() &&
+           std::isspace(static_cast<unsigned char>(text_[pos_]))) {
+      ++pos_;
+    }
+  }
+
+  bool eat(std::string_view token) {
+    skip_ws();
+    if (text_.substr(pos_, token.size()) == token) {
+      pos_ += token.size();
+      return true;
+    }
+    return false;
+  }
+
+  std::unique_ptr<Node> parse_or() {
+    auto node = parse_and();
+    while (eat("||")) {
+      if (node->kind != Node::kOr) {
+        auto parent = std::make_unique<Node>();
+        parent->kind = Node::kOr;
+        parent->kids.push_back(std::move(node));
+        node = std::move(parent);
+      }
+      node->kids.push_back(parse_and());
+    }
+    return node;
+  }
+
+  std::unique_ptr<Node> parse_and() {
+    auto node = parse_term();
+    while (eat("&&")) {
+      if (node->kind != Node::kAnd) {
+        auto parent = std::make_unique<Node>();
+        parent->kind = Node::kAnd;
+        parent->kids.push_back(std::move(node));
+        node = std::move(parent);
+      }
+      node->kids.push_back(parse_term());
+    }
+    return node;
+  }
+
+  std::unique_ptr<Node> parse_term() {
+    if (eat("!")) {
+      auto node = std::make_unique<Node>();
+      node->kind = Node::kNot;
+      node->kids.push_back(parse_term());
+      return node;
+    }
+    if (eat("(")) {
+      auto node = parse_or();
+      if (!eat(")")) fail("expected ')'");
+      return node;
+    }
+    return parse_comparison();
+  }
+
+  std::unique_ptr<Node> parse_comparison() {
+    skip_ws();
+    auto node = std::make_unique<Node>();
+    node->kind = Node::kCmp;
+
+    const std::size_t start = pos_;
+    while (pos_ < text_.size() &&
+           (std::isalnum(static_cast<unsigned char>(text_[pos_])) ||
+            text_[pos_] == '_' || text_[pos_] == '.')) {
+      ++pos_;
+    }
+    if (pos_ == start) fail("expected field name");
+    node->field = std::string(text_.substr(start, pos_ - start));
+
+    if (eat("==")) node->op = CmpOp::kEq;
+    else if (eat("!=")) node->op = CmpOp::kNe;
+    else if (eat("<=")) node->op = CmpOp::kLe;
+    else if (eat(">=")) node->op = CmpOp::kGe;
+    else if (eat("<")) node->op = CmpOp::kLt;
+    else if (eat(">")) node->op = CmpOp::kGt;
+    else fail("expected comparison operator");
+
+    parse_literal(*node);
+    return node;
+  }
+
+  void parse_literal(Node& node) {
+    skip_ws();
+    if (pos_ >= text_.size()) fail("expected literal");
+    const char c = text_[pos_];
+
+    if (c == '"' || c == '\'') {
+      ++pos_;
+      const std::size_t start = pos_;
+      while (pos_ < text_.size() && text_[pos_] != c) ++pos_;
+      if (pos_ >= text_.size()) fail("unterminated string");
+      node.lit = LitKind::kString;
+      node.str = std::string(text_.substr(start, pos_ - start));
+      ++pos_;
+      return;
+    }
+    if (eat("true")) {
+      node.lit = LitKind::kBool;
+      node.boolean = true;
+      return;
+    }
+    if (eat("false")) {
+      node.lit = LitKind::kBool;
+      node.boolean = false;
+      return;
+    }
+    if (eat("null")) {
+      node.lit = LitKind::kNull;
+      return;
+    }
+
+    const std::size_t start = pos_;
+    while (pos_ < text_.size() &&
+           (std::isdigit(static_cast<unsigned char>(text_[pos_])) ||
+            text_[pos_] == '-' || text_[pos_] == '+' || text_[pos_] == '.' ||
+            text_[pos_] == 'e' || text_[pos_] == 'E')) {
+      ++pos_;
+    }
+    double value;
+    if (start == pos_ ||
+        !parse_float(text_.substr(start, pos_ - start), value)) {
+      fail("expected literal");
+    }
+    node.lit = LitKind::kNumber;
+    node.num = value;
+  }
+
+  std::string_view text_;
+  std::size_t pos_ = 0;
+};
+
+constexpr std::size_t kArenaBatch = 4096;
+constexpr std::uint64_t kSampleRecords = 4096;
+
+}  // namespace
+
+FilterExpr FilterExpr::compile(std::string_view text) {
+  return FilterExpr(Parser(text).parse());
+}
+
+FilterExpr::FilterExpr(std::unique_ptr<Node> root) : root_(std::move(root)) {}
+FilterExpr::FilterExpr(FilterExpr&&) noexcept = default;
+FilterExpr& FilterExpr::operator=(FilterExpr&&) noexcept = default;
+FilterExpr::~FilterExpr() = default;
+
+bool FilterExpr::matches(LazyDocument& doc) const { return root_->eval(doc); }
+
+void FilterExpr::reoptimize() { root_->reoptimize(); }
+
+void scan_matching(const ParallelScanner& scanner, const MappedReader& reader,
+                   FilterExpr& filter, const ParallelScanner::RecordFn& fn) {
+  // Sampling prefix on the calling thread: fills the selectivity counters
+  // so the reordered plan fits this file's data, not last run's.
+  {
+    Arena arena;
+    auto cursor = reader.lines();
+    std::string_view record;
+    std::uint64_t n = 0;
+    while (n < kSampleRecords && cursor.next(record)) {
+      LazyDocument doc(record, arena);
+      filter.matches(doc);
+      if (++n % kArenaBatch == 0) arena.reset();
+    }
+  }
+  filter.reoptimize();
+
+  struct WorkerState {
+    Arena arena;
+    std::size_t records = 0;
+  };
+  std::vector<WorkerState> states(scanner.thread_count());
+  scanner.scan(reader, [&](std::string_view record, std::uint64_t offset,
+                           unsigned worker) {
+    WorkerState& st = states[worker];
+    LazyDocument doc(record, st.arena);
+    if (filter.matches(doc)) fn(record, offset, worker);
+    if (++st.records % kArenaBatch == 0) st.arena.reset();
+  });
+}
+
+}  // namespace jsonl
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "io/mapped_reader.h"
+#include "parse/lazy_document.h"
+#include "scan/parallel_scanner.h"
+
+namespace jsonl {
+
+// Compiled filter expressions pushed down into the scan.
+//
+// A small predicate language over top-level record fields:
+//
+//   status >= 500 && endpoint == "/api/checkout"
+//   (user_id == "u42" || user_id == "u43") && !(status < 400)
+//
+// Comparisons: == != < <= > >= against number, string, true/false or null
+// literals; combinators: && || ! and parentheses. A comparison on a
+// missing field is false.
+//
+// compile() parses the expression once into an evaluation plan. During
+// evaluation each comparison keeps pass/eval counters; reoptimize()
+// reorders AND operands cheapest-reject-first and OR operands
+// cheapest-accept-first from those observed selectivities, so a selective
+// conjunct is tested before expensive ones. Evaluation extracts only the
+// fields a record actually needs (short-circuit plus lazy parsing), which
+// lets highly selective filters reject most records after one field.
+class FilterExpr {
+ public:
+  struct Node;  // opaque; defined in filter_expr.cpp
+
+  // Throws std::invalid_argument with a position message on bad syntax.
+  static FilterExpr compile(std::string_view text);
+
+  FilterExpr(FilterExpr&&) noexcept;
+  FilterExpr& operator=(FilterExpr&&) noexcept;
+  ~FilterExpr();
+
+  // Evaluates against one record. Thread-safe; counter updates are
+  // relaxed atomics.
+  bool matches(LazyDocument& doc) const;
+
+  // Reorders AND/OR operands by observed selectivity. Not thread-safe
+  // against concurrent matches(); call between scans (scan_matching does
+  // this after a sampling prefix).
+  void reoptimize();
+
+ private:
+  explicit FilterExpr(std::unique_ptr<Node> root);
+  std::unique_ptr<Node> root_;
+};
+
+// Filtered parallel scan: evaluates `filter` on a single-threaded sampling
+// prefix (first few thousand records), reoptimizes the plan from the
+// observed selectivities, then runs the full work-stealing scan delivering
+// only matching records to `fn`.
+void scan_matching(const ParallelScanner& scanner, const MappedReader& reader,
+                   FilterExpr& filter, const ParallelScanner::RecordFn& fn);
+
+}  // namespace jsonl
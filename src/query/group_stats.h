@@ -0,0 +1,131 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "query/aggregate_engine.h"
+
+// Shared per-group accumulator internals for aggregate_engine and
+// stats_cache; a cached chunk summary must merge bit-identically with a
+// live scan, so both sides use these types.
+
+namespace jsonl {
+namespace query_detail {
+
+// Log-linear histogram: 64 major buckets by bit width, 16 minor buckets
+// each. Bounded memory per group, ~3% relative quantile error.
+struct Histogram {
+  static constexpr unsigned kMinorBits = 4;
+  static constexpr unsigned kBuckets = 64 << kMinorBits;
+
+  std::vector<std::uint32_t> counts;
+
+  void record(double value) {
+    if (counts.empty()) counts.resize(kBuckets, 0);
+    // NaN and anything at or beyond 2^63 saturate into the top major
+    // bucket: the cast to u64 is UB for NaN and values >= 2^64, and a
+    // 64-bit-wide value would index one past the bucket array.
+    std::uint64_t v = !(value > 0) ? 0
+                      : value >= 0x1p63 ? ~std::uint64_t{0} >> 1
+                                        : static_cast<std::uint64_t>(value);
+    unsigned major = v == 0 ? 0 : 64 - std::countl_zero(v);
+    unsigned minor =
+        major <= kMinorBits
+            ? static_cast<unsigned>(v) & ((1u << kMinorBits) - 1)
+            : static_cast<unsigned>(v >> (major - 1 - kMinorBits)) &
+                  ((1u << kMinorBits) - 1);
+    ++counts[(major << kMinorBits) | minor];
+  }
+
+  void merge(const Histogram& other) {
+    if (other.counts.empty()) return;
+    if (counts.empty()) counts.resize(kBuckets, 0);
+    for (unsigned i = 0; i < kBuckets; ++i) counts[i] += other.counts[i];
+  }
+
+  double quantile(double q, std::uint64_t total) const {
+    if (counts.empty() || total == 0) return 0.0;
+    std::uint64_t rank = static_cast<std::uint64_t>(q * (total - 1));
+    std::uint64_t seen = 0;
+    for (unsigned i = 0; i < kBuckets; ++i) {
+      seen += counts[i];
+      if (seen > rank) {
+        unsigned major = i >> kMinorBits;
+        unsigned minor = i & ((1u << kMinorBits) - 1);
+        if (major <= kMinorBits) return minor;
+        std::uint64_t base = std::uint64_t{1} << (major - 1);
+        return static_cast<double>(
+            base + (static_cast<std::uint64_t>(minor) << (major - 1 - kMinorBits)));
+      }
+    }
+    return 0.0;
+  }
+};
+
+struct Group {
+  std::uint64_t count = 0;
+  double sum = 0.0;
+  double min = std::numeric_limits<double>::infinity();
+  double max = -std::numeric_limits<double>::infinity();
+  Histogram hist;
+};
+
+using GroupTable = std::unordered_map<std::string, Group>;
+
+inline void merge_into(GroupTable& dst, const GroupTable& src) {
+  for (const auto& [key, g] : src) {
+    Group& into = dst[key];
+    into.count += g.count;
+    into.sum += g.sum;
+    if (g.min < into.min) into.min = g.min;
+    if (g.max > into.max) into.max = g.max;
+    into.hist.merge(g.hist);
+  }
+}
+
+inline std::vector<GroupResult> finalize(const GroupTable& merged,
+                                         bool percentiles) {
+  std::vector<GroupResult> results;
+  results.reserve(merged.size());
+  for (const auto& [key, g] : merged) {
+    GroupResult r;
+    r.key = key;
+    r.count = g.count;
+    r.sum = g.sum;
+    r.min = std::isinf(g.min) ? 0.0 : g.min;
+    r.max = std::isinf(g.max) ? 0.0 : g.max;
+    if (percentiles) {
+      r.p50 = g.hist.quantile(0.50, g.count);
+      r.p99 = g.hist.quantile(0.99, g.count);
+    }
+    results.push_back(std::move(r));
+  }
+  std::sort(results.begin(), results.end(),
+            [](const GroupResult& a, const GroupResult& b) {
+              return a.count > b.count;
+            });
+  return results;
+}
+
+// Accumulates one record's contribution. Extraction mirrors the engine's
+// specialized scan loop; this form is for the incremental (per-record)
+// paths where a virtual-free template loop buys nothing.
+inline void accumulate(Group& g, bool has_field, bool percentiles,
+                       double value) {
+  ++g.count;
+  if (has_field) {
+    g.sum += value;
+    if (value < g.min) g.min = value;
+    if (value > g.max) g.max = value;
+    if (percentiles) g.hist.record(value);
+  }
+}
+
+}  // namespace query_detail
+}  // namespace jsonl
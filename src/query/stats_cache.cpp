@@ -0,0 +1,272 @@
+#include "query/stats_cache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <system_error>
+
+#include "parse/lazy_document.h"
+
+namespace jsonl {
+
+namespace {
+
+constexpr std::uint32_t kMagic = 0x43534c4a;  // "JLSC"
+constexpr std::uint32_t kVersion = 2;  // v2: time bound joined the identity
+constexpr std::size_t kNameBytes = 64;
+constexpr std::size_t kArenaBatch = 4096;
+
+struct Header {
+  std::uint32_t magic = kMagic;
+  std::uint32_t version = kVersion;
+  std::uint64_t chunk_bytes = 0;
+  char group_by[kNameBytes] = {};
+  char field[kNameBytes] = {};
+  char time_field[kNameBytes] = {};
+  std::int64_t time_begin_ms = 0;
+  std::int64_t time_end_ms = 0;
+  std::uint8_t field_type = 0;
+  std::uint8_t want_percentiles = 0;
+  std::uint8_t pad[6] = {};
+  std::uint64_t chunk_count = 0;
+};
+static_assert(sizeof(Header) == 240);
+
+void write_bytes(std::FILE* f, const void* p, std::size_t n,
+                 const std::string& path) {
+  if (std::fwrite(p, 1, n, f) != n) {
+    throw std::system_error(errno, std::generic_category(), "write " + path);
+  }
+}
+
+void read_bytes(std::FILE* f, void* p, std::size_t n,
+                const std::string& path) {
+  if (std::fread(p, 1, n, f) != n) {
+    throw std::system_error(EIO, std::generic_category(),
+                            "short read " + path);
+  }
+}
+
+}  // namespace
+
+StatsCache::StatsCache(std::string log_path, AggregateQuery query)
+    : StatsCache(std::move(log_path), std::move(query), Options{}) {}
+
+StatsCache::StatsCache(std::string log_path, AggregateQuery query,
+                       const Options& options)
+    : log_path_(std::move(log_path)), query_(std::move(query)),
+      opt_(options) {
+  if (opt_.cache_path.empty()) opt_.cache_path = log_path_ + ".stats";
+  load();
+  open_.begin = covered_;
+  open_.end = covered_;
+  accum_end_ = covered_;
+}
+
+void StatsCache::load() {
+  std::FILE* f = std::fopen(opt_.cache_path.c_str(), "rb");
+  if (f == nullptr) return;  // no sidecar yet
+
+  Header h;
+  if (std::fread(&h, 1, sizeof(h), f) != sizeof(h) || h.magic != kMagic ||
+      h.version != kVersion || h.chunk_bytes != opt_.chunk_bytes ||
+      std::strncmp(h.group_by, query_.group_by.c_str(), kNameBytes) != 0 ||
+      std::strncmp(h.field, query_.field.c_str(), kNameBytes) != 0 ||
+      std::strncmp(h.time_field, query_.time_field.c_str(), kNameBytes) !=
+          0 ||
+      h.time_begin_ms != query_.time_begin_ms ||
+      h.time_end_ms != query_.time_end_ms ||
+      h.field_type != static_cast<std::uint8_t>(query_.field_type) ||
+      h.want_percentiles != (query_.want_percentiles ? 1 : 0)) {
+    // Different query or layout: start fresh, the first refresh rebuilds.
+    std::fclose(f);
+    return;
+  }
+
+  try {
+    chunks_.reserve(h.chunk_count);
+    for (std::uint64_t c = 0; c < h.chunk_count; ++c) {
+      ChunkStats chunk;
+      std::uint32_t group_count = 0;
+      read_bytes(f, &chunk.begin, 8, opt_.cache_path);
+      read_bytes(f, &chunk.end, 8, opt_.cache_path);
+      read_bytes(f, &group_count, 4, opt_.cache_path);
+      for (std::uint32_t g = 0; g < group_count; ++g) {
+        std::uint32_t key_len = 0;
+        read_bytes(f, &key_len, 4, opt_.cache_path);
+        std::string key(key_len, '\0');
+        read_bytes(f, key.data(), key_len, opt_.cache_path);
+        query_detail::Group& grp = chunk.groups[std::move(key)];
+        read_bytes(f, &grp.count, 8, opt_.cache_path);
+        read_bytes(f, &grp.sum, 8, opt_.cache_path);
+        read_bytes(f, &grp.min, 8, opt_.cache_path);
+        read_bytes(f, &grp.max, 8, opt_.cache_path);
+        std::uint8_t has_hist = 0;
+        read_bytes(f, &has_hist, 1, opt_.cache_path);
+        if (has_hist != 0) {
+          grp.hist.counts.resize(query_detail::Histogram::kBuckets);
+          read_bytes(f, grp.hist.counts.data(),
+                     grp.hist.counts.size() * 4, opt_.cache_path);
+        }
+      }
+      chunks_.push_back(std::move(chunk));
+    }
+  } catch (...) {
+    std::fclose(f);
+    throw;
+  }
+  std::fclose(f);
+  if (!chunks_.empty()) covered_ = chunks_.back().end;
+}
+
+void StatsCache::save() const {
+  const std::string tmp = opt_.cache_path + ".tmp";
+  std::FILE* f = std::fopen(tmp.c_str(), "wb");
+  if (f == nullptr) {
+    throw std::system_error(errno, std::generic_category(), "open " + tmp);
+  }
+
+  try {
+    Header h;
+    h.chunk_bytes = opt_.chunk_bytes;
+    std::strncpy(h.group_by, query_.group_by.c_str(), kNameBytes - 1);
+    std::strncpy(h.field, query_.field.c_str(), kNameBytes - 1);
+    std::strncpy(h.time_field, query_.time_field.c_str(), kNameBytes - 1);
+    h.time_begin_ms = query_.time_begin_ms;
+    h.time_end_ms = query_.time_end_ms;
+    h.field_type = static_cast<std::uint8_t>(query_.field_type);
+    h.want_percentiles = query_.want_percentiles ? 1 : 0;
+    h.chunk_count = chunks_.size();
+    write_bytes(f, &h, sizeof(h), tmp);
+
+    for (const ChunkStats& chunk : chunks_) {
+      const std::uint32_t group_count =
+          static_cast<std::uint32_t>(chunk.groups.size());
+      write_bytes(f, &chunk.begin, 8, tmp);
+      write_bytes(f, &chunk.end, 8, tmp);
+      write_bytes(f, &group_count, 4, tmp);
+      for (const auto& [key, grp] : chunk.groups) {
+        const std::uint32_t key_len = static_cast<std::uint32_t>(key.size());
+        write_bytes(f, &key_len, 4, tmp);
+        write_bytes(f, key.data(), key_len, tmp);
+        write_bytes(f, &grp.count, 8, tmp);
+        write_bytes(f, &grp.sum, 8, tmp);
+        write_bytes(f, &grp.min, 8, tmp);
+        write_bytes(f, &grp.max, 8, tmp);
+        const std::uint8_t has_hist = grp.hist.counts.empty() ? 0 : 1;
+        write_bytes(f, &has_hist, 1, tmp);
+        if (has_hist != 0) {
+          write_bytes(f, grp.hist.counts.data(),
+                      grp.hist.counts.size() * 4, tmp);
+        }
+      }
+    }
+  } catch (...) {
+    std::fclose(f);
+    std::remove(tmp.c_str());
+    throw;
+  }
+  if (std::fclose(f) != 0 ||
+      std::rename(tmp.c_str(), opt_.cache_path.c_str()) != 0) {
+    throw std::system_error(errno, std::generic_category(),
+                            "rename " + tmp);
+  }
+}
+
+void StatsCache::accumulate_record(query_detail::GroupTable& table,
+                                   std::string_view record,
+                                   Arena& arena) const {
+  LazyDocument doc(record, arena);
+
+  // Same exclusion the engine applies: a bounded query drops records
+  // whose timestamp is missing or outside [begin, end) entirely, so the
+  // cached summaries merge to identical results.
+  if (!query_.time_field.empty()) {
+    const Value tv = doc[query_.time_field];
+    const std::int64_t ts = tv.as_timestamp_ms(INT64_MIN);
+    if (!tv || ts < query_.time_begin_ms || ts >= query_.time_end_ms) {
+      return;
+    }
+  }
+
+  std::string_view key;
+  if (!query_.group_by.empty()) key = doc[query_.group_by].as_string();
+
+  const bool has_field = !query_.field.empty();
+  double value = 0.0;
+  if (has_field) {
+    const Value v = doc[query_.field];
+    value = query_.field_type == FieldType::kInt64
+                ? static_cast<double>(v.as_int64())
+                : v.as_double();
+  }
+  query_detail::accumulate(table[std::string(key)], has_field,
+                           has_field && query_.want_percentiles, value);
+}
+
+void StatsCache::seal_open_chunk() {
+  covered_ = open_.end;
+  chunks_.push_back(std::move(open_));
+  open_ = ChunkStats{};
+  open_.begin = covered_;
+  open_.end = covered_;
+  save();
+}
+
+void StatsCache::observe(std::string_view record, std::uint64_t offset) {
+  if (offset < accum_end_) return;  // already summarized
+  open_.end = offset + record.size() + 1;
+  accum_end_ = open_.end;
+  accumulate_record(open_.groups, record, arena_);
+  if (++observed_ % kArenaBatch == 0) arena_.reset();
+  if (open_.end - open_.begin >= opt_.chunk_bytes) seal_open_chunk();
+}
+
+std::size_t StatsCache::refresh() {
+  const std::size_t sealed_before = chunks_.size();
+  MappedReader reader(log_path_);
+  if (reader.size() <= accum_end_) return 0;
+
+  auto cursor = reader.lines_at(accum_end_, reader.size() - accum_end_);
+  std::string_view record;
+  std::uint64_t offset = accum_end_;
+  while (cursor.next(record)) {
+    // A torn final record (no newline yet) is a write in progress; leave
+    // it for the next refresh so offsets stay record-aligned.
+    if (offset + record.size() >= reader.size()) break;
+    observe(record, offset);
+    offset = accum_end_;
+  }
+  return chunks_.size() - sealed_before;
+}
+
+std::vector<GroupResult> StatsCache::run(const MappedReader& reader) const {
+  query_detail::GroupTable merged;
+  for (const ChunkStats& chunk : chunks_) {
+    query_detail::merge_into(merged, chunk.groups);
+  }
+  query_detail::merge_into(merged, open_.groups);
+
+  // Unsummarized tail: whatever the reader has past what we've seen.
+  if (reader.size() > accum_end_) {
+    auto cursor = reader.lines_at(accum_end_, reader.size() - accum_end_);
+    std::string_view record;
+    Arena arena;
+    std::size_t n = 0;
+    std::uint64_t offset = accum_end_;
+    while (cursor.next(record)) {
+      if (offset + record.size() >= reader.size()) break;  // torn tail
+      accumulate_record(merged, record, arena);
+      offset += record.size() + 1;
+      if (++n % kArenaBatch == 0) arena.reset();
+    }
+  }
+  return query_detail::finalize(
+      merged, !query_.field.empty() && query_.want_percentiles);
+}
+
+std::vector<GroupResult> StatsCache::run() const {
+  MappedReader reader(log_path_);
+  return run(reader);
+}
+
+}  // namespace jsonl
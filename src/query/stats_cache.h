@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "parse/arena.h"
+#include "query/aggregate_engine.h"
+#include "query/group_stats.h"
+
+namespace jsonl {
+
+// Persistent per-chunk pre-aggregates for one standing AggregateQuery.
+//
+// Dashboards recompute the same rollups over an append-only log every few
+// minutes; this cache makes that a merge instead of a rescan. The log is
+// summarized in fixed-size chunks (by byte range, sealed at record
+// boundaries); each sealed chunk's group table — counts, sums, min/max
+// and the same log-linear histograms the engine uses — is persisted to a
+// .stats sidecar. run() then merges the sealed summaries, the in-memory
+// partial chunk and a scan of only the unsummarized tail, producing
+// results identical to AggregateEngine over the whole file.
+//
+// Maintenance is incremental: refresh() summarizes exactly the bytes
+// appended since last time, and observe() accepts records straight from a
+// TailFollower callback so a follower process keeps the cache warm as
+// data arrives. The sidecar is rewritten atomically (tmp + rename) per
+// sealed chunk; a crash loses at most the open partial chunk, which the
+// next refresh() rebuilds from the log. A sidecar written for a different
+// query or chunk size is ignored and rebuilt.
+class StatsCache {
+ public:
+  struct Options {
+    std::size_t chunk_bytes = 64u << 20;
+    std::string cache_path;  // default: <log>.stats
+  };
+
+  // Loads the sidecar if present and compatible. Throws std::system_error
+  // if it exists but cannot be read.
+  StatsCache(std::string log_path, AggregateQuery query);
+  StatsCache(std::string log_path, AggregateQuery query,
+             const Options& options);
+
+  // Summarizes bytes appended since the last refresh/observe. Returns the
+  // number of newly sealed chunks.
+  std::size_t refresh();
+
+  // Tail-follow hook: accounts one record at absolute `offset` (its start
+  // in the log). Records must arrive in file order.
+  void observe(std::string_view record, std::uint64_t offset);
+
+  // Full-file results: cached chunks + partial chunk + tail scan. The
+  // reader must map the same log this cache summarizes.
+  std::vector<GroupResult> run(const MappedReader& reader) const;
+  std::vector<GroupResult> run() const;
+
+  // Byte offset up to which sealed, persisted summaries exist.
+  std::uint64_t covered() const noexcept { return covered_; }
+  std::size_t chunk_count() const noexcept { return chunks_.size(); }
+
+ private:
+  struct ChunkStats {
+    std::uint64_t begin = 0;
+    std::uint64_t end = 0;
+    query_detail::GroupTable groups;
+  };
+
+  void load();
+  void save() const;
+  void accumulate_record(query_detail::GroupTable& table,
+                         std::string_view record, Arena& arena) const;
+  void seal_open_chunk();
+
+  std::string log_path_;
+  AggregateQuery query_;
+  Options opt_;
+
+  std::vector<ChunkStats> chunks_;  // sealed and persisted
+  std::uint64_t covered_ = 0;       // == chunks_.back().end
+  ChunkStats open_;                 // accumulating, in memory only
+  std::uint64_t accum_end_ = 0;     // next unseen byte (>= covered_)
+  mutable Arena arena_;
+  std::size_t observed_ = 0;        // arena reset cadence
+};
+
+}  // namespace jsonl
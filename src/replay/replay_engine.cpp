@@ -0,0 +1,230 @@
+#include "replay/replay_engine.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+#include "async/async_stream.h"
+#include "parse/lazy_document.h"
+#include "query/group_stats.h"
+
+namespace jsonl {
+
+namespace replay_detail {
+
+// Shared between the dispatch coroutine and sink threads: in_flight gates
+// dispatch, the latency histogram is mutex-protected because completions
+// arrive on whatever threads the sink's responses land on.
+struct Tracker {
+  std::atomic<std::size_t> in_flight{0};
+  std::atomic<std::uint64_t> completed{0};
+  std::atomic<std::uint64_t> abandoned{0};
+  std::mutex mutex;
+  query_detail::Histogram latency_us;
+  double max_latency_us = 0.0;
+
+  ReplayEngine::Completion issue(std::int64_t sent_ns) noexcept {
+    return ReplayEngine::Completion(this, sent_ns);
+  }
+};
+
+}  // namespace replay_detail
+
+namespace {
+
+constexpr std::int64_t kNoTimestamp = std::numeric_limits<std::int64_t>::min();
+constexpr std::size_t kArenaBatch = 4096;
+
+std::int64_t now_ns() noexcept {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Everything the dispatch coroutine touches, passed by reference so the
+// coroutine frame holds no captures (a capturing lambda coroutine would
+// outlive its closure).
+struct PaceContext {
+  const MappedReader& log;
+  const LineIndex& index;
+  const ReplayOptions& options;
+  const ReplayEngine::SendFn& send;
+  Executor& executor;
+  replay_detail::Tracker& tracker;
+  ReplayReport& report;
+  std::uint64_t first;
+  std::uint64_t last;
+
+  std::int64_t ts0 = kNoTimestamp;     // first seen record timestamp
+  std::int64_t wall0 = 0;              // wall clock at ts0's dispatch
+  std::int64_t last_due_ns = 0;
+  std::int64_t first_send_ns = 0;
+  std::int64_t last_send_ns = 0;
+};
+
+Task pace(PaceContext& ctx) {
+  const std::string_view bytes = ctx.log.data();
+  Arena arena;
+  std::size_t parsed = 0;
+
+  for (std::uint64_t i = ctx.first; i < ctx.last; ++i) {
+    const LineIndex::Range r = ctx.index.range(i);
+    std::string_view record = bytes.substr(r.offset, r.length);
+    if (!record.empty() && record.back() == '\n') record.remove_suffix(1);
+
+    LazyDocument doc(record, arena);
+    const std::int64_t ts =
+        doc[ctx.options.timestamp_field].as_timestamp_ms(kNoTimestamp);
+    if (++parsed % kArenaBatch == 0) arena.reset();
+
+    std::int64_t due_ns;
+    if (ts == kNoTimestamp) {
+      ++ctx.report.missing_timestamp;
+      due_ns = now_ns();
+    } else {
+      if (ctx.ts0 == kNoTimestamp) {
+        ctx.ts0 = ts;
+        ctx.wall0 = now_ns();
+      }
+      due_ns = ctx.wall0 +
+               static_cast<std::int64_t>(static_cast<double>(ts - ctx.ts0) *
+                                         1e6 / ctx.options.speed);
+      ctx.last_due_ns = due_ns;
+    }
+
+    if (now_ns() < due_ns ||
+        ctx.tracker.in_flight.load(std::memory_order_relaxed) >=
+            ctx.options.max_in_flight) {
+      co_await ctx.executor.until([&ctx, due_ns] {
+        return now_ns() >= due_ns &&
+               ctx.tracker.in_flight.load(std::memory_order_relaxed) <
+                   ctx.options.max_in_flight;
+      });
+    }
+
+    const std::int64_t sent_ns = now_ns();
+    if (ts != kNoTimestamp) {
+      const double lag_ms = static_cast<double>(sent_ns - due_ns) / 1e6;
+      if (lag_ms > ctx.report.max_send_lag_ms) {
+        ctx.report.max_send_lag_ms = lag_ms;
+      }
+    }
+    if (ctx.first_send_ns == 0) ctx.first_send_ns = sent_ns;
+    ctx.last_send_ns = sent_ns;
+
+    ctx.tracker.in_flight.fetch_add(1, std::memory_order_relaxed);
+    ++ctx.report.records_sent;
+    ctx.send(record, ctx.tracker.issue(sent_ns));
+  }
+
+  // Drain: wait for every outstanding request to complete or be abandoned.
+  co_await ctx.executor.until([&ctx] {
+    return ctx.tracker.in_flight.load(std::memory_order_acquire) == 0;
+  });
+}
+
+}  // namespace
+
+ReplayEngine::Completion& ReplayEngine::Completion::operator=(
+    Completion&& other) noexcept {
+  if (this != &other) {
+    if (tracker_ != nullptr) {
+      tracker_->abandoned.fetch_add(1, std::memory_order_relaxed);
+      tracker_->in_flight.fetch_sub(1, std::memory_order_release);
+    }
+    tracker_ = other.tracker_;
+    sent_ns_ = other.sent_ns_;
+    other.tracker_ = nullptr;
+  }
+  return *this;
+}
+
+ReplayEngine::Completion::~Completion() {
+  if (tracker_ != nullptr) {
+    tracker_->abandoned.fetch_add(1, std::memory_order_relaxed);
+    tracker_->in_flight.fetch_sub(1, std::memory_order_release);
+  }
+}
+
+void ReplayEngine::Completion::done() {
+  if (tracker_ == nullptr) return;
+  const double latency_us =
+      static_cast<double>(now_ns() - sent_ns_) / 1e3;
+  {
+    std::lock_guard<std::mutex> lock(tracker_->mutex);
+    tracker_->latency_us.record(latency_us);
+    if (latency_us > tracker_->max_latency_us) {
+      tracker_->max_latency_us = latency_us;
+    }
+  }
+  tracker_->completed.fetch_add(1, std::memory_order_relaxed);
+  tracker_->in_flight.fetch_sub(1, std::memory_order_release);
+  tracker_ = nullptr;
+}
+
+ReplayReport ReplayEngine::run(const SendFn& send) const {
+  ReplayReport report;
+  const std::uint64_t total = index_->record_count();
+  const std::uint64_t first = std::min(options_.first_record, total);
+  const std::uint64_t last =
+      total - first < options_.record_count ? total
+                                            : first + options_.record_count;
+  if (first >= last) return report;
+
+  replay_detail::Tracker tracker;
+  Executor executor;
+  PaceContext ctx{*log_,   *index_, options_, send, executor,
+                  tracker, report,  first,    last};
+
+  const std::int64_t run_start = now_ns();
+  executor.spawn(pace(ctx));
+  executor.run();
+  const std::int64_t run_end = now_ns();
+
+  report.records_completed = tracker.completed.load();
+  report.records_abandoned = tracker.abandoned.load();
+  report.wall_seconds = static_cast<double>(run_end - run_start) / 1e9;
+  if (ctx.last_due_ns > ctx.wall0 && ctx.ts0 != kNoTimestamp) {
+    report.target_rate =
+        static_cast<double>(report.records_sent) /
+        (static_cast<double>(ctx.last_due_ns - ctx.wall0) / 1e9);
+  }
+  if (ctx.last_send_ns > ctx.first_send_ns) {
+    report.achieved_rate =
+        static_cast<double>(report.records_sent) /
+        (static_cast<double>(ctx.last_send_ns - ctx.first_send_ns) / 1e9);
+  }
+  const std::uint64_t completed = report.records_completed;
+  report.latency_p50_ms = tracker.latency_us.quantile(0.5, completed) / 1e3;
+  report.latency_p99_ms = tracker.latency_us.quantile(0.99, completed) / 1e3;
+  report.latency_max_ms = tracker.max_latency_us / 1e3;
+  return report;
+}
+
+std::string ReplayReport::to_json() const {
+  std::string out;
+  out.reserve(384);
+  out += '{';
+  auto field = [&](const char* name, const std::string& value) {
+    if (out.size() > 1) out += ", ";
+    out += '"';
+    out += name;
+    out += "\": ";
+    out += value;
+  };
+  field("records_sent", std::to_string(records_sent));
+  field("records_completed", std::to_string(records_completed));
+  field("records_abandoned", std::to_string(records_abandoned));
+  field("missing_timestamp", std::to_string(missing_timestamp));
+  field("wall_seconds", std::to_string(wall_seconds));
+  field("target_rate", std::to_string(target_rate));
+  field("achieved_rate", std::to_string(achieved_rate));
+  field("max_send_lag_ms", std::to_string(max_send_lag_ms));
+  field("latency_p50_ms", std::to_string(latency_p50_ms));
+  field("latency_p99_ms", std::to_string(latency_p99_ms));
+  field("latency_max_ms", std::to_string(latency_max_ms));
+  out += '}';
+  return out;
+}
+
+}  // namespace jsonl
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+
+#include "index/line_index.h"
+#include "io/mapped_reader.h"
+
+namespace jsonl {
+
+// Load-shaping replay of a captured JSONL log against a live target.
+//
+// Records are scheduled on the wall clock by their original timestamps
+// scaled by a speed multiplier, so a staging run reproduces production's
+// burst shape instead of a flat synthetic rate. One Executor thread paces
+// the dispatch loop; the sink callback owns the actual connections and
+// acknowledges each request through a Completion token from whatever
+// thread its response lands on, so a few threads drive thousands of
+// in-flight requests. The engine throttles at max_in_flight, rides the
+// LineIndex for record access (replaying "records 41,000,000-41,000,500"
+// is a first/count pair, no scanning), and reports achieved-vs-target
+// rate, scheduling lag and response latency percentiles.
+
+struct ReplayOptions {
+  std::string timestamp_field = "timestamp";
+
+  // Multiple of the original rate: 1.0 replays in real time, 2.0 at twice
+  // production speed.
+  double speed = 1.0;
+
+  // Dispatch stalls while this many requests await their Completion.
+  std::size_t max_in_flight = 1000;
+
+  // Slice of the log to replay, in record numbers.
+  std::uint64_t first_record = 0;
+  std::uint64_t record_count = std::numeric_limits<std::uint64_t>::max();
+};
+
+struct ReplayReport {
+  std::uint64_t records_sent = 0;
+  std::uint64_t records_completed = 0;
+  std::uint64_t records_abandoned = 0;   // Completion dropped without done()
+  std::uint64_t missing_timestamp = 0;   // dispatched immediately
+  double wall_seconds = 0.0;
+  double target_rate = 0.0;    // records/s the scaled schedule called for
+  double achieved_rate = 0.0;  // records/s actually dispatched
+  double max_send_lag_ms = 0.0;  // worst dispatch distance behind schedule
+  double latency_p50_ms = 0.0;
+  double latency_p99_ms = 0.0;
+  double latency_max_ms = 0.0;
+
+  // One JSON object, field names as above.
+  std::string to_json() const;
+};
+
+namespace replay_detail {
+struct Tracker;
+}
+
+class ReplayEngine {
+ public:
+  // Handed to the sink with each record; call done() from any thread when
+  // the response arrives. A token destroyed without done() counts the
+  // request as abandoned instead of stalling the replay at max_in_flight.
+  class Completion {
+   public:
+    Completion(Completion&& other) noexcept
+        : tracker_(other.tracker_), sent_ns_(other.sent_ns_) {
+      other.tracker_ = nullptr;
+    }
+    Completion& operator=(Completion&& other) noexcept;
+    ~Completion();
+
+    Completion(const Completion&) = delete;
+    Completion& operator=(const Completion&) = delete;
+
+    void done();
+
+   private:
+    friend class ReplayEngine;
+    friend struct replay_detail::Tracker;
+    Completion(replay_detail::Tracker* tracker, std::int64_t sent_ns) noexcept
+        : tracker_(tracker), sent_ns_(sent_ns) {}
+
+    replay_detail::Tracker* tracker_;
+    std::int64_t sent_ns_;
+  };
+
+  // The record view is valid only for the duration of the call; sinks that
+  // queue the request copy what they need.
+  using SendFn = std::function<void(std::string_view record, Completion done)>;
+
+  ReplayEngine(const MappedReader& log, const LineIndex& index,
+               ReplayOptions options = {})
+      : log_(&log), index_(&index), options_(std::move(options)) {}
+
+  // Blocks until every scheduled record is dispatched and either completed
+  // or abandoned.
+  ReplayReport run(const SendFn& send) const;
+
+ private:
+  const MappedReader* log_;
+  const LineIndex* index_;
+  ReplayOptions options_;
+};
+
+}  // namespace jsonl
@@ -0,0 +1,126 @@
+#include "scan/merge_reader.h"
+
+#include <limits>
+
+#include "parse/lazy_document.h"
+#include "perf/trace.h"
+
+namespace jsonl {
+
+namespace {
+
+// Records with no parseable timestamp sort ahead of everything real; an
+// exhausted shard sorts behind everything real.
+constexpr std::int64_t kNoTimestamp = std::numeric_limits<std::int64_t>::min();
+constexpr std::int64_t kExhausted = std::numeric_limits<std::int64_t>::max();
+
+std::uint32_t pow2_at_least(std::uint32_t n) noexcept {
+  std::uint32_t p = 1;
+  while (p < n) p <<= 1;
+  return p;
+}
+
+}  // namespace
+
+MergeReader::MergeReader(const std::vector<std::string>& shard_paths)
+    : MergeReader(shard_paths, Options{}) {}
+
+MergeReader::MergeReader(const std::vector<std::string>& shard_paths,
+                         const Options& options)
+    : opt_(options) {
+  // The tree is padded to a power of two with permanently exhausted
+  // virtual shards, which keeps every leaf at the same depth and the
+  // replay path branch-free on shape.
+  const std::uint32_t real = static_cast<std::uint32_t>(shard_paths.size());
+  const std::uint32_t k = pow2_at_least(real == 0 ? 1 : real);
+  shards_.reserve(k);
+  for (std::uint32_t s = 0; s < k; ++s) {
+    shards_.push_back(std::make_unique<Shard>());
+  }
+  ReaderOptions ropt;
+  ropt.backend = opt_.backend;
+  for (std::uint32_t s = 0; s < k; ++s) {
+    if (s < real) {
+      shards_[s]->reader = open_reader(shard_paths[s], ropt);
+      refill(s);
+    } else {
+      shards_[s]->exhausted = true;
+    }
+  }
+
+  // Initial tournament, bottom-up: winners bubble toward the root, each
+  // internal node keeps the loser of its match.
+  tree_.assign(k, 0);
+  std::vector<std::uint32_t> win(2 * k);
+  for (std::uint32_t s = 0; s < k; ++s) win[k + s] = s;
+  auto beats = [this](std::uint32_t a, std::uint32_t b) noexcept {
+    const std::int64_t ka = key_of(a), kb = key_of(b);
+    return ka != kb ? ka < kb : a < b;
+  };
+  for (std::uint32_t node = k - 1; node >= 1; --node) {
+    const std::uint32_t a = win[2 * node], b = win[2 * node + 1];
+    if (beats(a, b)) {
+      win[node] = a;
+      tree_[node] = b;
+    } else {
+      win[node] = b;
+      tree_[node] = a;
+    }
+  }
+  winner_ = k > 1 ? win[1] : 0;
+}
+
+MergeReader::~MergeReader() = default;
+
+std::int64_t MergeReader::key_of(std::uint32_t shard) const noexcept {
+  const Shard& s = *shards_[shard];
+  if (s.head >= s.buffer.size()) return kExhausted;
+  return s.buffer[s.head].ts;
+}
+
+void MergeReader::refill(std::uint32_t shard) {
+  perf::TraceSpan span("merge_refill");
+  Shard& s = *shards_[shard];
+  s.buffer.clear();
+  s.head = 0;
+  s.arena.reset();
+  std::string_view record;
+  while (s.buffer.size() < opt_.readahead_records && s.reader->next(record)) {
+    LazyDocument doc(record, s.arena);
+    const std::int64_t ts =
+        doc[opt_.timestamp_field].as_timestamp_ms(kNoTimestamp);
+    s.buffer.push_back(Entry{ts, std::string(record)});
+  }
+  if (s.buffer.empty()) s.exhausted = true;
+}
+
+void MergeReader::replay(std::uint32_t leaf) {
+  const std::uint32_t k = static_cast<std::uint32_t>(shards_.size());
+  std::uint32_t cur = leaf;
+  std::int64_t cur_key = key_of(cur);
+  for (std::uint32_t node = (k + leaf) / 2; node >= 1; node /= 2) {
+    const std::int64_t node_key = key_of(tree_[node]);
+    if (node_key < cur_key ||
+        (node_key == cur_key && tree_[node] < cur)) {
+      std::swap(tree_[node], cur);
+      cur_key = node_key;
+    }
+  }
+  winner_ = cur;
+}
+
+bool MergeReader::next(std::string_view& record) {
+  Shard& s = *shards_[winner_];
+  if (s.head >= s.buffer.size()) return false;  // all shards exhausted
+
+  current_ = std::move(s.buffer[s.head].record);
+  ++s.head;
+  if (s.head >= s.buffer.size() && !s.exhausted) refill(winner_);
+  replay(winner_);
+
+  emitted_bytes_ += current_.size() + 1;  // record plus its newline
+  record = current_;
+  return true;
+}
+
+}  // namespace jsonl
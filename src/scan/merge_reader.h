@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "io/reader.h"
+#include "parse/arena.h"
+
+namespace jsonl {
+
+// K-way merge over sharded logs, ordered by a timestamp field.
+//
+// Production writes one requests.jsonl per host; jobs that need global
+// time order were concatenating and sorting — 2x the log size in scratch
+// and hours of runtime. This reader streams instead: each shard (already
+// time-ordered locally) feeds a loser tree keyed on the record's
+// timestamp, so every next() is one leaf-to-root replay, O(log k)
+// comparisons for k shards.
+//
+// Shards are read through the Reader interface (mmap or io_uring per
+// ReaderBackend), and each keeps a readahead buffer of decoded
+// (timestamp, record) entries refilled in batches, so the merge loop
+// runs against memory while the kernel streams the next stretch of each
+// shard. Records missing a parseable timestamp sort first rather than
+// aborting a 400-shard run.
+//
+// Implements Reader itself, so merge output drops into any scan loop;
+// offset() reports cumulative bytes emitted across shards.
+class MergeReader final : public Reader {
+ public:
+  struct Options {
+    std::string timestamp_field = "timestamp";
+    ReaderBackend backend = ReaderBackend::kAuto;
+    std::size_t readahead_records = 256;  // per shard
+  };
+
+  // Throws std::system_error if any shard fails to open.
+  explicit MergeReader(const std::vector<std::string>& shard_paths);
+  MergeReader(const std::vector<std::string>& shard_paths,
+              const Options& options);
+  ~MergeReader() override;
+
+  bool next(std::string_view& record) override;
+  std::uint64_t offset() const noexcept override { return emitted_bytes_; }
+
+ private:
+  struct Entry {
+    std::int64_t ts;
+    std::string record;
+  };
+
+  struct Shard {
+    std::unique_ptr<Reader> reader;
+    std::vector<Entry> buffer;  // readahead, consumed front to back
+    std::size_t head = 0;
+    bool exhausted = false;
+    Arena arena;  // timestamp extraction scratch, reset per refill
+  };
+
+  void refill(std::uint32_t shard);
+  std::int64_t key_of(std::uint32_t shard) const noexcept;
+  void replay(std::uint32_t leaf);
+
+  Options opt_;
+  std::vector<std::unique_ptr<Shard>> shards_;  // Arena makes Shard immovable
+  std::vector<std::uint32_t> tree_;  // loser tree internal nodes
+  std::uint32_t winner_ = 0;
+  std::string current_;  // record handed out by the last next()
+  std::uint64_t emitted_bytes_ = 0;
+};
+
+}  // namespace jsonl
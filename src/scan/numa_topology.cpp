@@ -0,0 +1,36 @@
+#include "scan/numa_topology.h"
+
+#if WORK_SAMPLES_HAVE_NUMA
+#include <numa.h>
+#endif
+
+namespace jsonl::numa {
+
+#if WORK_SAMPLES_HAVE_NUMA
+
+bool available() noexcept {
+  static const bool ok =
+      ::numa_available() >= 0 && ::numa_max_node() > 0;
+  return ok;
+}
+
+unsigned node_count() noexcept {
+  if (!available()) return 1;
+  return static_cast<unsigned>(::numa_max_node()) + 1;
+}
+
+void bind_current_thread(unsigned node) noexcept {
+  if (!available()) return;
+  ::numa_run_on_node(static_cast<int>(node));
+  ::numa_set_preferred(static_cast<int>(node));
+}
+
+#else
+
+bool available() noexcept { return false; }
+unsigned node_count() noexcept { return 1; }
+void bind_current_thread(unsigned) noexcept {}
+
+#endif
+
+}  // namespace jsonl::numa
@@ -0,0 +1,26 @@
+#pragma once
+
+namespace jsonl::numa {
+
+// Thin wrapper over libnuma, compiled to no-ops when the library is not
+// available at build time.
+//
+// The scanner's locality story is first-touch: a worker bound to a node
+// both runs and faults its chunks there, so page-cache pages for a chunk
+// land on the node that scans them. Binding also sets the node as the
+// thread's preferred allocation target, which makes per-worker arenas and
+// scratch buffers node-local without any allocator changes.
+
+// True when libnuma is compiled in, the kernel exposes NUMA and the
+// machine has more than one node; single-node boxes report false so
+// callers skip the binding work entirely.
+bool available() noexcept;
+
+// Number of memory nodes (1 when !available()).
+unsigned node_count() noexcept;
+
+// Binds the calling thread's execution and preferred memory placement to
+// `node`. No-op when !available().
+void bind_current_thread(unsigned node) noexcept;
+
+}  // namespace jsonl::numa
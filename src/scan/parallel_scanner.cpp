@@ -0,0 +1,232 @@
+#include "scan/parallel_scanner.h"
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "io/chunked_zstd.h"
+#include "perf/scan_stats.h"
+#include "perf/trace.h"
+#include "scan/numa_topology.h"
+
+namespace jsonl {
+
+namespace {
+
+// Half-open range of chunk indices owned by one worker, packed into a
+// single atomic word (begin in the high half, end in the low half) so both
+// the owner's pop-front and a thief's steal-half are lone CAS operations.
+struct alignas(64) ChunkRange {
+  std::atomic<std::uint64_t> word{0};
+
+  static std::uint64_t pack(std::uint32_t begin, std::uint32_t end) noexcept {
+    return (static_cast<std::uint64_t>(begin) << 32) | end;
+  }
+  static std::uint32_t begin_of(std::uint64_t w) noexcept {
+    return static_cast<std::uint32_t>(w >> 32);
+  }
+  static std::uint32_t end_of(std::uint64_t w) noexcept {
+    return static_cast<std::uint32_t>(w);
+  }
+
+  // Owner side: claim the next chunk from the front.
+  bool pop(std::uint32_t& chunk) noexcept {
+    std::uint64_t w = word.load(std::memory_order_relaxed);
+    while (begin_of(w) < end_of(w)) {
+      std::uint64_t next = pack(begin_of(w) + 1, end_of(w));
+      if (word.compare_exchange_weak(w, next, std::memory_order_acq_rel)) {
+        chunk = begin_of(w);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Thief side: take the back half of the victim's remaining range.
+  bool steal(std::uint32_t& lo, std::uint32_t& hi) noexcept {
+    std::uint64_t w = word.load(std::memory_order_relaxed);
+    while (true) {
+      std::uint32_t b = begin_of(w), e = end_of(w);
+      if (b >= e) return false;
+      std::uint32_t mid = b + (e - b + 1) / 2;
+      if (word.compare_exchange_weak(w, pack(b, mid),
+                                     std::memory_order_acq_rel)) {
+        lo = mid;
+        hi = e;
+        return true;
+      }
+    }
+  }
+
+  std::uint32_t remaining() const noexcept {
+    std::uint64_t w = word.load(std::memory_order_relaxed);
+    std::uint32_t b = begin_of(w), e = end_of(w);
+    return b < e ? e - b : 0;
+  }
+};
+
+// Work-stealing driver shared by the plain and compressed scans: divides
+// `chunk_count` chunk indices between `workers` threads and runs
+// `run_chunk(chunk, worker)` for every index exactly once. When NUMA
+// binding is on, workers are spread round-robin across nodes before they
+// touch any data.
+template <typename RunChunk>
+void run_work_stealing(unsigned workers, std::uint32_t chunk_count,
+                       bool numa_aware, const RunChunk& run_chunk) {
+  const unsigned nodes =
+      numa_aware && numa::available() ? numa::node_count() : 0;
+  std::vector<ChunkRange> ranges(workers);
+  const std::uint32_t per = chunk_count / workers;
+  const std::uint32_t extra = chunk_count % workers;
+  std::uint32_t next = 0;
+  for (unsigned w = 0; w < workers; ++w) {
+    std::uint32_t take = per + (w < extra ? 1 : 0);
+    ranges[w].word.store(ChunkRange::pack(next, next + take),
+                         std::memory_order_relaxed);
+    next += take;
+  }
+
+  auto worker_main = [&](unsigned self) {
+    if (nodes != 0) numa::bind_current_thread(self % nodes);
+    while (true) {
+      std::uint32_t chunk;
+      if (ranges[self].pop(chunk)) {
+        run_chunk(chunk, self);
+        continue;
+      }
+      // Steal from the worker with the most chunks left.
+      unsigned victim = workers;
+      std::uint32_t best = 0;
+      for (unsigned w = 0; w < workers; ++w) {
+        std::uint32_t rem = ranges[w].remaining();
+        if (rem > best) {
+          best = rem;
+          victim = w;
+        }
+      }
+      if (victim == workers) return;
+      std::uint32_t lo, hi;
+      if (ranges[victim].steal(lo, hi)) {
+        ranges[self].word.store(ChunkRange::pack(lo, hi),
+                                std::memory_order_release);
+        perf::counters().chunk_steals.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+  };
+
+  if (workers <= 1) {
+    worker_main(0);
+    return;
+  }
+  std::vector<std::thread> pool;
+  pool.reserve(workers - 1);
+  for (unsigned w = 1; w < workers; ++w) {
+    pool.emplace_back(worker_main, w);
+  }
+  worker_main(0);
+  for (std::thread& t : pool) t.join();
+}
+
+}  // namespace
+
+ParallelScanner::ParallelScanner(ScanOptions options)
+    : chunk_size_(options.chunk_size != 0 ? options.chunk_size : (1 << 20)),
+      threads_(options.threads != 0 ? options.threads
+                                    : std::thread::hardware_concurrency()),
+      numa_aware_(options.numa_aware) {
+  if (threads_ == 0) threads_ = 1;
+}
+
+void ParallelScanner::scan(std::string_view bytes, const RecordFn& fn) const {
+  scan(bytes, ChunkPredicate(), fn);
+}
+
+void ParallelScanner::scan(std::string_view bytes, const ChunkPredicate& keep,
+                           const RecordFn& fn) const {
+  if (bytes.empty()) return;
+
+  const std::uint32_t chunk_count = static_cast<std::uint32_t>(
+      (bytes.size() + chunk_size_ - 1) / chunk_size_);
+  const unsigned workers =
+      threads_ < chunk_count ? threads_ : static_cast<unsigned>(chunk_count);
+
+  // Chunk boundaries re-synchronize forward: a chunk starts at the first
+  // record boundary at or after its nominal offset and runs to the first
+  // record boundary at or after the next chunk's nominal offset. The record
+  // straddling a boundary belongs to the earlier chunk.
+  auto resync = [&](std::uint64_t nominal) noexcept -> std::uint64_t {
+    if (nominal == 0) return 0;
+    if (nominal >= bytes.size()) return bytes.size();
+    const char* nl = static_cast<const char*>(std::memchr(
+        bytes.data() + nominal - 1, '\n', bytes.size() - (nominal - 1)));
+    if (nl == nullptr) return bytes.size();
+    return static_cast<std::uint64_t>(nl - bytes.data()) + 1;
+  };
+
+  auto run_chunk = [&](std::uint32_t chunk, unsigned worker) {
+    const std::uint64_t start = resync(std::uint64_t{chunk} * chunk_size_);
+    const std::uint64_t stop = resync(std::uint64_t{chunk + 1} * chunk_size_);
+    if (start >= stop) return;
+    perf::ThreadCounters& tc = perf::counters();
+    if (keep && !keep(start, stop)) {
+      tc.chunks_skipped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    perf::TraceSpan span("scan_chunk");
+    MappedReader::LineCursor cursor(
+        bytes.substr(start, stop - start));
+    std::string_view record;
+    std::uint64_t offset = start;
+    std::uint64_t emitted = 0;
+    while (cursor.next(record)) {
+      fn(record, offset, worker);
+      offset = start + cursor.offset();
+      ++emitted;
+    }
+    tc.chunks_scanned.fetch_add(1, std::memory_order_relaxed);
+    tc.bytes_scanned.fetch_add(stop - start, std::memory_order_relaxed);
+    tc.records_emitted.fetch_add(emitted, std::memory_order_relaxed);
+  };
+
+  run_work_stealing(workers, chunk_count, numa_aware_, run_chunk);
+}
+
+void ParallelScanner::scan(const ChunkedZstdReader& reader,
+                           const RecordFn& fn) const {
+  const std::vector<FrameInfo>& frames = reader.frames();
+  if (frames.empty()) return;
+
+  const std::uint32_t chunk_count = static_cast<std::uint32_t>(frames.size());
+  const unsigned workers =
+      threads_ < chunk_count ? threads_ : static_cast<unsigned>(chunk_count);
+
+  // Frames are already record-aligned, so each is an independent work unit;
+  // per-worker buffers are reused across frames.
+  std::vector<std::vector<char>> buffers(workers);
+
+  run_work_stealing(workers, chunk_count, numa_aware_,
+                    [&](std::uint32_t chunk, unsigned worker) {
+    perf::TraceSpan span("scan_chunk");
+    const FrameInfo& frame = frames[chunk];
+    std::vector<char>& buf = buffers[worker];
+    if (buf.size() < frame.raw_size) buf.resize(frame.raw_size);
+    const std::size_t raw =
+        reader.decompress_frame(chunk, buf.data(), buf.size());
+    MappedReader::LineCursor cursor(std::string_view(buf.data(), raw));
+    std::string_view record;
+    std::uint64_t offset = frame.raw_offset;
+    std::uint64_t emitted = 0;
+    while (cursor.next(record)) {
+      fn(record, offset, worker);
+      offset = frame.raw_offset + cursor.offset();
+      ++emitted;
+    }
+    perf::ThreadCounters& tc = perf::counters();
+    tc.chunks_scanned.fetch_add(1, std::memory_order_relaxed);
+    tc.bytes_scanned.fetch_add(raw, std::memory_order_relaxed);
+    tc.records_emitted.fetch_add(emitted, std::memory_order_relaxed);
+  });
+}
+
+}  // namespace jsonl
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+#include "io/mapped_reader.h"
+
+namespace jsonl {
+
+class ChunkedZstdReader;
+
+struct ScanOptions {
+  // Nominal chunk size before newline re-synchronization. 1 MiB keeps a
+  // chunk and its parse output comfortably inside L2 while amortizing
+  // scheduling overhead over thousands of records.
+  std::size_t chunk_size = 1 << 20;
+
+  // Worker thread count; 0 means one per hardware thread.
+  unsigned threads = 0;
+
+  // On multi-node machines, bind workers round-robin across NUMA nodes.
+  // Workers fault the pages of their own chunk share, so first-touch
+  // places chunk pages on the node that scans them, and the preferred
+  // policy keeps per-worker scratch allocations local; work stealing then
+  // crosses nodes only when a node runs dry. No effect on single-node
+  // machines or builds without libnuma.
+  bool numa_aware = true;
+};
+
+// Runs a per-record callback over a mapped JSONL file on all cores.
+//
+// The byte range is split into fixed-size chunks and each chunk boundary is
+// re-synchronized forward to the nearest newline, so every record is
+// delivered exactly once and entirely from one chunk. Chunks are divided
+// evenly between workers up front; a worker that drains its share steals
+// half of the largest remaining share, which keeps cores busy when record
+// sizes (and callback costs) vary wildly across sections of the log.
+//
+// The callback runs concurrently on all workers and must be thread-safe
+// with respect to its own state. `worker` is a dense index in
+// [0, thread_count) for per-worker accumulators.
+class ParallelScanner {
+ public:
+  using RecordFn = std::function<void(
+      std::string_view record, std::uint64_t offset, unsigned worker)>;
+
+  explicit ParallelScanner(ScanOptions options = {});
+
+  // Scans the whole file, blocking until every record has been delivered.
+  void scan(const MappedReader& reader, const RecordFn& fn) const {
+    scan(reader.data(), fn);
+  }
+
+  // Scans an arbitrary byte range (e.g. a decompressed region).
+  void scan(std::string_view bytes, const RecordFn& fn) const;
+
+  // Chunk-skipping scan: `keep` is consulted with each chunk's resolved
+  // byte range before any record in it is touched, so sidecar structures
+  // (Bloom filters, zone maps) can prune whole chunks out of the pass.
+  using ChunkPredicate = std::function<bool(std::uint64_t begin,
+                                            std::uint64_t end)>;
+  void scan(const MappedReader& reader, const ChunkPredicate& keep,
+            const RecordFn& fn) const {
+    scan(reader.data(), keep, fn);
+  }
+  void scan(std::string_view bytes, const ChunkPredicate& keep,
+            const RecordFn& fn) const;
+
+  // Scans a chunked zstd container: compressed frames are the work units,
+  // decompressed in parallel into per-worker buffers. Record offsets are
+  // positions in the uncompressed log, matching the plain-file overloads.
+  void scan(const ChunkedZstdReader& reader, const RecordFn& fn) const;
+
+  unsigned thread_count() const noexcept { return threads_; }
+
+ private:
+  std::size_t chunk_size_;
+  unsigned threads_;
+  bool numa_aware_;
+};
+
+}  // namespace jsonl
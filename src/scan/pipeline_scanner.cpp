@@ -0,0 +1,217 @@
+#include "scan/pipeline_scanner.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "perf/scan_stats.h"
+#include "perf/trace.h"
+
+namespace jsonl {
+
+namespace {
+
+std::int64_t now_ns() noexcept {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// One split range: the record boundaries are found once by the split
+// stage, so the callback stage walks precomputed slices instead of
+// re-scanning for newlines.
+struct Batch {
+  std::uint64_t base = 0;       // byte offset of the first record
+  std::string_view bytes;       // whole-record span
+  std::vector<std::uint32_t> bounds;  // offsets one past each record
+};
+
+}  // namespace
+
+PipelineScanner::PipelineScanner(PipelineOptions options)
+    : options_(options),
+      threads_(options.threads != 0 ? options.threads
+                                    : std::thread::hardware_concurrency()) {
+  if (threads_ == 0) threads_ = 1;
+  if (options_.min_batch_bytes == 0) options_.min_batch_bytes = 1;
+  if (options_.max_batch_bytes < options_.min_batch_bytes) {
+    options_.max_batch_bytes = options_.min_batch_bytes;
+  }
+}
+
+void PipelineScanner::scan(std::string_view bytes, const RecordFn& fn) const {
+  if (bytes.empty()) return;
+
+  const std::size_t capacity =
+      options_.queue_batches != 0 ? options_.queue_batches : 2 * threads_;
+  const std::size_t high_water = (capacity + 1) / 2;
+
+  // Same boundary convention as ParallelScanner: a range starts at the
+  // first record boundary at or after its nominal offset, and the record
+  // straddling a boundary belongs to the earlier range.
+  auto resync = [&](std::uint64_t nominal) noexcept -> std::uint64_t {
+    if (nominal == 0) return 0;
+    if (nominal >= bytes.size()) return bytes.size();
+    const char* nl = static_cast<const char*>(std::memchr(
+        bytes.data() + nominal - 1, '\n', bytes.size() - (nominal - 1)));
+    if (nl == nullptr) return bytes.size();
+    return static_cast<std::uint64_t>(nl - bytes.data()) + 1;
+  };
+
+  std::mutex mutex;
+  std::deque<Batch> queue;
+  std::atomic<std::uint64_t> cursor{0};
+  std::atomic<bool> produced_all{false};
+  std::atomic<std::size_t> target_bytes{
+      std::min(options_.max_batch_bytes,
+               std::max(options_.min_batch_bytes,
+                        bytes.size() / (std::size_t{threads_} * 16 + 1)))};
+
+  // Consumer-side feedback: rescale the batch so one batch is roughly
+  // target_batch_ms of callback work, smoothed 3:1 against the previous
+  // target. Races between consumers just average harder.
+  const double target_ns = options_.target_batch_ms * 1e6;
+  auto adapt = [&](std::size_t batch_size, std::int64_t elapsed_ns) {
+    if (elapsed_ns <= 0) return;
+    const std::size_t old_target =
+        target_bytes.load(std::memory_order_relaxed);
+    double desired = static_cast<double>(batch_size) * target_ns /
+                     static_cast<double>(elapsed_ns);
+    if (desired < static_cast<double>(options_.min_batch_bytes)) {
+      desired = static_cast<double>(options_.min_batch_bytes);
+    }
+    if (desired > static_cast<double>(options_.max_batch_bytes)) {
+      desired = static_cast<double>(options_.max_batch_bytes);
+    }
+    const std::size_t next = static_cast<std::size_t>(
+        (3.0 * static_cast<double>(old_target) + desired) / 4.0);
+    if (next != old_target) {
+      target_bytes.store(next, std::memory_order_relaxed);
+      const std::size_t delta =
+          next > old_target ? next - old_target : old_target - next;
+      if (delta > old_target / 8) {
+        perf::counters().batch_resizes.fetch_add(1,
+                                                 std::memory_order_relaxed);
+      }
+    }
+  };
+
+  auto split_one = [&]() -> bool {
+    const std::size_t take = target_bytes.load(std::memory_order_relaxed);
+    const std::uint64_t nominal =
+        cursor.fetch_add(take, std::memory_order_relaxed);
+    if (nominal >= bytes.size()) {
+      produced_all.store(true, std::memory_order_release);
+      return false;
+    }
+    const std::uint64_t start = resync(nominal);
+    const std::uint64_t stop = resync(nominal + take);
+    if (start >= stop) return true;  // range swallowed by resync; go on
+
+    perf::TraceSpan span("split_batch");
+    Batch batch;
+    batch.base = start;
+    batch.bytes = bytes.substr(start, stop - start);
+    std::size_t pos = 0;
+    while (pos < batch.bytes.size()) {
+      const char* nl = static_cast<const char*>(std::memchr(
+          batch.bytes.data() + pos, '\n', batch.bytes.size() - pos));
+      if (nl == nullptr) {
+        batch.bounds.push_back(
+            static_cast<std::uint32_t>(batch.bytes.size()));
+        break;
+      }
+      pos = static_cast<std::size_t>(nl - batch.bytes.data()) + 1;
+      batch.bounds.push_back(static_cast<std::uint32_t>(pos));
+    }
+    perf::ThreadCounters& tc = perf::counters();
+    tc.chunks_scanned.fetch_add(1, std::memory_order_relaxed);
+    tc.bytes_scanned.fetch_add(stop - start, std::memory_order_relaxed);
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      queue.push_back(std::move(batch));
+    }
+    return true;
+  };
+
+  auto deliver = [&](Batch& batch, unsigned worker) {
+    perf::TraceSpan span("deliver_batch");
+    const std::int64_t t0 = now_ns();
+    std::uint32_t prev = 0;
+    for (std::uint32_t bound : batch.bounds) {
+      std::string_view record = batch.bytes.substr(prev, bound - prev);
+      if (!record.empty() && record.back() == '\n') record.remove_suffix(1);
+      fn(record, batch.base + prev, worker);
+      prev = bound;
+    }
+    perf::counters().records_emitted.fetch_add(batch.bounds.size(),
+                                               std::memory_order_relaxed);
+    adapt(batch.bytes.size(), now_ns() - t0);
+  };
+
+  auto worker_main = [&](unsigned self) {
+    enum class Stage { kNone, kSplit, kDeliver };
+    Stage last = Stage::kNone;
+    while (true) {
+      // Pick a stage from queue depth: drain a backlog (or a full queue)
+      // before splitting more, otherwise keep the queue fed.
+      Batch batch;
+      bool have_batch = false;
+      bool try_split = false;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        const bool backlog = queue.size() >= high_water;
+        const bool full = queue.size() >= capacity;
+        if (!queue.empty() &&
+            (full || backlog || produced_all.load(std::memory_order_acquire))) {
+          batch = std::move(queue.front());
+          queue.pop_front();
+          have_batch = true;
+        } else if (!produced_all.load(std::memory_order_acquire)) {
+          try_split = true;
+        } else if (!queue.empty()) {
+          batch = std::move(queue.front());
+          queue.pop_front();
+          have_batch = true;
+        }
+      }
+      if (have_batch) {
+        if (last == Stage::kSplit) {
+          perf::counters().stage_switches.fetch_add(
+              1, std::memory_order_relaxed);
+        }
+        last = Stage::kDeliver;
+        deliver(batch, self);
+        continue;
+      }
+      if (try_split) {
+        if (last == Stage::kDeliver) {
+          perf::counters().stage_switches.fetch_add(
+              1, std::memory_order_relaxed);
+        }
+        last = Stage::kSplit;
+        split_one();
+        continue;
+      }
+      return;  // input exhausted and queue drained
+    }
+  };
+
+  if (threads_ <= 1) {
+    worker_main(0);
+    return;
+  }
+  std::vector<std::thread> pool;
+  pool.reserve(threads_ - 1);
+  for (unsigned w = 1; w < threads_; ++w) {
+    pool.emplace_back(worker_main, w);
+  }
+  worker_main(0);
+  for (std::thread& t : pool) t.join();
+}
+
+}  // namespace jsonl
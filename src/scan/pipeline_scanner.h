@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "io/mapped_reader.h"
+#include "scan/parallel_scanner.h"
+
+namespace jsonl {
+
+struct PipelineOptions {
+  // Total worker budget shared by both stages; 0 means one per hardware
+  // thread.
+  unsigned threads = 0;
+
+  // Bounds for the adaptive batch size. The scheduler starts in the
+  // middle and converges on whatever size makes one batch roughly
+  // target_batch_ms of callback work.
+  std::size_t min_batch_bytes = 64 << 10;
+  std::size_t max_batch_bytes = 8 << 20;
+  double target_batch_ms = 2.0;
+
+  // Bound on split-but-undelivered batches; 0 means twice the worker
+  // count. Caps the pipeline's buffered bytes when callbacks fall behind.
+  std::size_t queue_batches = 0;
+};
+
+// Two-stage pipelined scan with adaptive batching.
+//
+// ParallelScanner's fixed chunk size is a compromise: tiny records make
+// per-chunk scheduling overhead dominate, huge records and slow callbacks
+// leave splitting threads idle behind one straggler. Here the split stage
+// (claim a byte range, find record boundaries) and the callback stage
+// (deliver records) are decoupled by a bounded batch queue, and every
+// worker picks its stage per iteration from queue depth: a backlog pulls
+// workers onto callbacks, a drained queue pushes them back to splitting.
+// Thread rebalancing is therefore continuous and free — no stage owns a
+// thread.
+//
+// Batch size adapts from observed callback throughput: after each batch
+// the consumer rescales the target so one batch costs ~target_batch_ms,
+// clamped to [min, max]. Sections of the log with 100x larger records
+// settle on proportionally fewer records per batch within a few batches.
+// Adjustments and stage changes show up in ScanStats (batch_resizes,
+// stage_switches); batches and bytes count into the chunk counters.
+//
+// Callback contract matches ParallelScanner: records delivered exactly
+// once, concurrently, with a dense worker index.
+class PipelineScanner {
+ public:
+  using RecordFn = ParallelScanner::RecordFn;
+
+  explicit PipelineScanner(PipelineOptions options = {});
+
+  void scan(const MappedReader& reader, const RecordFn& fn) const {
+    scan(reader.data(), fn);
+  }
+  void scan(std::string_view bytes, const RecordFn& fn) const;
+
+  unsigned thread_count() const noexcept { return threads_; }
+
+ private:
+  PipelineOptions options_;
+  unsigned threads_;
+};
+
+}  // namespace jsonl
@@ -0,0 +1,363 @@
+#include "scan/structural_index.h"
+
+#include <cstddef>
+#include <cstring>
+
+#include "perf/trace.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace jsonl {
+
+namespace {
+
+// Kernels produce a 64-bit mask per 64-byte block with a bit set for every
+// byte equal to '\n', '{', '}', '"' or ':'; extraction into the two offset
+// vectors is shared and branch-light (one ctz per set bit).
+
+inline bool is_interesting(char c) noexcept {
+  return c == '\n' || c == '{' || c == '}' || c == '"' || c == ':';
+}
+
+using BlockFn = std::uint64_t (*)(const char*) noexcept;
+
+std::uint64_t block_mask_scalar(const char* p) noexcept {
+  std::uint64_t mask = 0;
+  for (int i = 0; i < 64; ++i) {
+    mask |= static_cast<std::uint64_t>(is_interesting(p[i])) << i;
+  }
+  return mask;
+}
+
+#if defined(__x86_64__)
+
+__attribute__((target("avx2"))) std::uint32_t lane_mask_avx2(
+    const __m256i v) noexcept {
+  __m256i hits = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'));
+  hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('{')));
+  hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('}')));
+  hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')));
+  hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(':')));
+  return static_cast<std::uint32_t>(_mm256_movemask_epi8(hits));
+}
+
+__attribute__((target("avx2"))) std::uint64_t block_mask_avx2(
+    const char* p) noexcept {
+  const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+  const __m256i hi =
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+  return static_cast<std::uint64_t>(lane_mask_avx2(lo)) |
+         (static_cast<std::uint64_t>(lane_mask_avx2(hi)) << 32);
+}
+
+__attribute__((target("avx512bw"))) std::uint64_t block_mask_avx512(
+    const char* p) noexcept {
+  const __m512i v = _mm512_loadu_si512(p);
+  std::uint64_t mask = _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8('\n'));
+  mask |= _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8('{'));
+  mask |= _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8('}'));
+  mask |= _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8('"'));
+  mask |= _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8(':'));
+  return mask;
+}
+
+#endif  // __x86_64__
+
+// ---------------------------------------------------------------------------
+// Fused UTF-8 validation.
+//
+// State carried between 64-byte blocks. The vector kernel keeps the last 32
+// input bytes (continuation checks reach up to 3 bytes back across the block
+// boundary), a sticky per-lane error accumulator, and a mask of lanes where
+// the previous block ended inside a multi-byte sequence. The scalar kernel
+// uses only the DFA state word.
+struct Utf8State {
+  unsigned char prev[32] = {};
+  unsigned char err[32] = {};
+  unsigned char incomplete[32] = {};
+  std::uint32_t dfa = 0;  // 0 = accept
+};
+
+using Utf8BlockFn = void (*)(Utf8State&, const char*) noexcept;
+
+// Hoehrmann's UTF-8 DFA: the first 256 entries map a byte to its character
+// class, the rest are the transition table (states are multiples of 12;
+// 0 accepts, 12 rejects and is sticky).
+constexpr std::uint8_t kUtf8Dfa[] = {
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,  1,
+    9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,  9,
+    7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,
+    7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,
+    8,  8,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,
+    2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,  2,
+    10, 3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  3,  4,  3,  3,
+    11, 6,  6,  6,  5,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,  8,
+    0,  12, 24, 36, 60, 96, 84, 12, 12, 12, 48, 72,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 0,  12, 12, 12, 12, 12, 0,  12, 0,  12, 12,
+    12, 24, 12, 12, 12, 12, 12, 24, 12, 24, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 24, 12, 12, 12, 12,
+    12, 24, 12, 12, 12, 12, 12, 12, 12, 24, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 36, 12, 36, 12, 12,
+    12, 36, 12, 12, 12, 12, 12, 36, 12, 36, 12, 12,
+    12, 36, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+};
+
+void utf8_block_scalar(Utf8State& st, const char* p) noexcept {
+  std::uint32_t s = st.dfa;
+  for (int i = 0; i < 64; ++i) {
+    s = kUtf8Dfa[256 + s + kUtf8Dfa[static_cast<unsigned char>(p[i])]];
+  }
+  st.dfa = s;
+}
+
+#if defined(__x86_64__)
+
+// Error classes for the nibble lookups. A sequence error lights up exactly
+// when (high nibble of byte N-1, low nibble of byte N-1, high nibble of
+// byte N) agree on one of these bits; see Keiser & Lemire, "Validating
+// UTF-8 In Less Than One Instruction Per Byte".
+constexpr std::uint8_t kTooShort = 1 << 0;
+constexpr std::uint8_t kTooLong = 1 << 1;
+constexpr std::uint8_t kOverlong3 = 1 << 2;
+constexpr std::uint8_t kTooLarge = 1 << 3;
+constexpr std::uint8_t kSurrogate = 1 << 4;
+constexpr std::uint8_t kOverlong2 = 1 << 5;
+constexpr std::uint8_t kTooLarge1000 = 1 << 6;
+constexpr std::uint8_t kOverlong4 = 1 << 6;
+constexpr std::uint8_t kTwoConts = 1 << 7;
+constexpr std::uint8_t kCarry = kTooShort | kTooLong | kTwoConts;
+
+// Shifts `input` right by N bytes, pulling the vacated low bytes from the
+// end of `prev` (a 32-lane byte-granular shift across the 128-bit lanes).
+template <int N>
+__attribute__((target("avx2"))) __m256i utf8_prev(const __m256i input,
+                                                  const __m256i prev) noexcept {
+  const __m256i chained = _mm256_permute2x128_si256(prev, input, 0x21);
+  return _mm256_alignr_epi8(input, chained, 16 - N);
+}
+
+__attribute__((target("avx2"))) __m256i utf8_shr4(const __m256i v) noexcept {
+  return _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0F));
+}
+
+// Two-byte window checks: flags lone continuations, missing continuations,
+// overlong 2/3/4-byte leads, surrogates and > U+10FFFF code points.
+__attribute__((target("avx2"))) __m256i utf8_special_cases(
+    const __m256i input, const __m256i prev1) noexcept {
+  const __m256i byte1_high = _mm256_shuffle_epi8(
+      _mm256_setr_epi8(
+          kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong,
+          kTooLong, kTwoConts, kTwoConts, kTwoConts, kTwoConts,
+          kTooShort | kOverlong2, kTooShort,
+          kTooShort | kOverlong3 | kSurrogate,
+          kTooShort | kTooLarge | kTooLarge1000 | kOverlong4,
+          kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong,
+          kTooLong, kTwoConts, kTwoConts, kTwoConts, kTwoConts,
+          kTooShort | kOverlong2, kTooShort,
+          kTooShort | kOverlong3 | kSurrogate,
+          kTooShort | kTooLarge | kTooLarge1000 | kOverlong4),
+      utf8_shr4(prev1));
+  const __m256i byte1_low = _mm256_shuffle_epi8(
+      _mm256_setr_epi8(
+          kCarry | kOverlong2 | kOverlong3 | kOverlong4, kCarry | kOverlong2,
+          kCarry, kCarry, kCarry | kTooLarge,
+          kCarry | kTooLarge | kTooLarge1000,
+          kCarry | kTooLarge | kTooLarge1000,
+          kCarry | kTooLarge | kTooLarge1000,
+          kCarry | kTooLarge | kTooLarge1000,
+          kCarry | kTooLarge | kTooLarge1000,
+          kCarry | kTooLarge | kTooLarge1000,
+          kCarry | kTooLarge | kTooLarge1000,
+          kCarry | kTooLarge | kTooLarge1000,
+          kCarry | kTooLarge | kTooLarge1000 | kSurrogate,
+          kCarry | kTooLarge | kTooLarge1000,
+          kCarry | kTooLarge | kTooLarge1000,
+          kCarry | kOverlong2 | kOverlong3 | kOverlong4, kCarry | kOverlong2,
+          kCarry, kCarry, kCarry | kTooLarge,
+          kCarry | kTooLarge | kTooLarge1000,
+          kCarry | kTooLarge | kTooLarge1000,
+          kCarry | kTooLarge | kTooLarge1000,
+          kCarry | kTooLarge | kTooLarge1000,
+          kCarry | kTooLarge | kTooLarge1000,
+          kCarry | kTooLarge | kTooLarge1000,
+          kCarry | kTooLarge | kTooLarge1000,
+          kCarry | kTooLarge | kTooLarge1000,
+          kCarry | kTooLarge | kTooLarge1000 | kSurrogate,
+          kCarry | kTooLarge | kTooLarge1000,
+          kCarry | kTooLarge | kTooLarge1000),
+      _mm256_and_si256(prev1, _mm256_set1_epi8(0x0F)));
+  const std::uint8_t cont =
+      kTooLong | kOverlong2 | kTwoConts | kOverlong3;
+  const __m256i byte2_high = _mm256_shuffle_epi8(
+      _mm256_setr_epi8(
+          kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort,
+          kTooShort, kTooShort, cont | kTooLarge1000 | kOverlong4,
+          cont | kTooLarge,
+          kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+          kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+          kTooShort, kTooShort, kTooShort, kTooShort,
+          kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort,
+          kTooShort, kTooShort, cont | kTooLarge1000 | kOverlong4,
+          cont | kTooLarge,
+          kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+          kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+          kTooShort, kTooShort, kTooShort, kTooShort),
+      utf8_shr4(input));
+  return _mm256_and_si256(_mm256_and_si256(byte1_high, byte1_low), byte2_high);
+}
+
+// Third and fourth continuation bytes: lanes two (three) behind a 3-byte
+// (4-byte) lead must be continuations; xor cancels the kTwoConts bit the
+// special-case lookup set for legitimately seen continuations.
+__attribute__((target("avx2"))) __m256i utf8_check_block(
+    const __m256i input, const __m256i prev) noexcept {
+  const __m256i prev1 = utf8_prev<1>(input, prev);
+  const __m256i sc = utf8_special_cases(input, prev1);
+  const __m256i prev2 = utf8_prev<2>(input, prev);
+  const __m256i prev3 = utf8_prev<3>(input, prev);
+  const __m256i third =
+      _mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+  const __m256i fourth =
+      _mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+  const __m256i must23_80 =
+      _mm256_and_si256(_mm256_or_si256(third, fourth),
+                       _mm256_set1_epi8(static_cast<char>(0x80)));
+  return _mm256_xor_si256(must23_80, sc);
+}
+
+// Lanes where the chunk ends inside a multi-byte sequence: the last byte is
+// a 2/3/4-byte lead, or the second-to-last a 3/4-byte lead, etc.
+__attribute__((target("avx2"))) __m256i utf8_is_incomplete(
+    const __m256i input) noexcept {
+  const __m256i max_value = _mm256_setr_epi8(
+      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+      -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+      static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1),
+      static_cast<char>(0xC0 - 1));
+  return _mm256_subs_epu8(input, max_value);
+}
+
+__attribute__((target("avx2"))) void utf8_block_avx2(Utf8State& st,
+                                                     const char* p) noexcept {
+  __m256i prev =
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(st.prev));
+  __m256i err = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(st.err));
+  __m256i incomplete =
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(st.incomplete));
+  for (int half = 0; half < 2; ++half) {
+    const __m256i input = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(p + half * 32));
+    if (_mm256_movemask_epi8(input) == 0) {
+      // Pure ASCII: valid unless the previous chunk ended mid-sequence.
+      err = _mm256_or_si256(err, incomplete);
+      incomplete = _mm256_setzero_si256();
+    } else {
+      err = _mm256_or_si256(err, utf8_check_block(input, prev));
+      incomplete = utf8_is_incomplete(input);
+    }
+    prev = input;
+  }
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(st.prev), prev);
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(st.err), err);
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(st.incomplete), incomplete);
+}
+
+#endif  // __x86_64__
+
+// Input ends here: any accumulated error lane, a pending incomplete lane, or
+// a scalar DFA state mid-sequence means invalid.
+bool utf8_finish(const Utf8State& st) noexcept {
+  if (st.dfa != 0) return false;
+  unsigned char any = 0;
+  for (int i = 0; i < 32; ++i) any |= st.err[i] | st.incomplete[i];
+  return any == 0;
+}
+
+struct Dispatch {
+  BlockFn fn;
+  const char* name;
+  Utf8BlockFn utf8_fn;
+  const char* utf8_name;
+};
+
+Dispatch pick_kernel() noexcept {
+#if defined(__x86_64__)
+  if (__builtin_cpu_supports("avx512bw")) {
+    return {block_mask_avx512, "avx512bw", utf8_block_avx2, "avx2"};
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return {block_mask_avx2, "avx2", utf8_block_avx2, "avx2"};
+  }
+#endif
+  return {block_mask_scalar, "scalar", utf8_block_scalar, "scalar"};
+}
+
+const Dispatch& kernel() noexcept {
+  static const Dispatch d = pick_kernel();
+  return d;
+}
+
+}  // namespace
+
+const char* StructuralIndex::active_kernel() noexcept { return kernel().name; }
+
+const char* StructuralIndex::utf8_kernel() noexcept {
+  return kernel().utf8_name;
+}
+
+void StructuralIndex::build(std::string_view bytes) {
+  perf::TraceSpan span("structural_index");
+  clear();
+  const char* data = bytes.data();
+  const std::size_t size = bytes.size();
+  const BlockFn block = kernel().fn;
+  const Utf8BlockFn utf8_block = kernel().utf8_fn;
+  Utf8State utf8;
+
+  std::size_t pos = 0;
+  for (; pos + 64 <= size; pos += 64) {
+    utf8_block(utf8, data + pos);
+    std::uint64_t mask = block(data + pos);
+    while (mask != 0) {
+      const unsigned bit = static_cast<unsigned>(__builtin_ctzll(mask));
+      const std::uint32_t off = static_cast<std::uint32_t>(pos + bit);
+      if (data[off] == '\n') {
+        newlines_.push_back(off);
+      } else {
+        structurals_.push_back(off);
+      }
+      mask &= mask - 1;
+    }
+  }
+  if (pos < size) {
+    // Zero-padded final block: NUL is valid ASCII, and padding after a
+    // truncated sequence turns the pending-incomplete state into a hard
+    // error, which is the verdict a truncated range deserves anyway.
+    char tail[64] = {};
+    std::memcpy(tail, data + pos, size - pos);
+    utf8_block(utf8, tail);
+  }
+  for (; pos < size; ++pos) {
+    if (!is_interesting(data[pos])) continue;
+    const std::uint32_t off = static_cast<std::uint32_t>(pos);
+    if (data[pos] == '\n') {
+      newlines_.push_back(off);
+    } else {
+      structurals_.push_back(off);
+    }
+  }
+  utf8_valid_ = utf8_finish(utf8);
+}
+
+}  // namespace jsonl
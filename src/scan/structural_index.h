@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace jsonl {
+
+// Vectorized structural scan over a JSONL byte range.
+//
+// A single pass records the offsets of newline boundaries and of the JSON
+// structural characters '{', '}', '"' and ':' so that downstream parsing can
+// jump straight to field boundaries instead of re-inspecting every byte. The
+// scan runs 64 bytes at a time with AVX-512BW or AVX2 kernels when the CPU
+// supports them, falling back to a scalar loop otherwise; the kernel is
+// selected once at first use.
+//
+// The same pass validates the bytes as UTF-8 while they are cache-resident,
+// so callers that must certify content (partner extracts) get validation for
+// free instead of a second sweep over the data. The vector kernel is the
+// nibble-lookup algorithm of Keiser and Lemire; the scalar fallback is a
+// byte-at-a-time DFA.
+//
+// Offsets are 32-bit and relative to the start of the scanned range, which
+// therefore must not exceed 4 GiB. Callers scanning a large mapped file are
+// expected to index one chunk at a time (the chunking layers above already
+// work in far smaller units).
+class StructuralIndex {
+ public:
+  StructuralIndex() = default;
+
+  // Clears any previous index and scans `bytes`.
+  void build(std::string_view bytes);
+
+  // Offsets of '\n' bytes, in ascending order.
+  const std::vector<std::uint32_t>& newlines() const noexcept {
+    return newlines_;
+  }
+
+  // Offsets of '{', '}', '"' and ':' bytes, in ascending order. The caller
+  // distinguishes them by looking at the input byte at each offset.
+  const std::vector<std::uint32_t>& structurals() const noexcept {
+    return structurals_;
+  }
+
+  // Whether the last build() saw well-formed UTF-8: no overlong encodings,
+  // no surrogate code points, no out-of-range or truncated sequences. A
+  // range that ends mid-sequence is invalid; validate whole records.
+  bool utf8_valid() const noexcept { return utf8_valid_; }
+
+  void clear() noexcept {
+    newlines_.clear();
+    structurals_.clear();
+    utf8_valid_ = true;
+  }
+
+  // Name of the kernel the runtime dispatch picked on this machine:
+  // "avx512bw", "avx2" or "scalar". Useful in benchmark output.
+  static const char* active_kernel() noexcept;
+
+  // Name of the fused UTF-8 validation kernel: "avx2" or "scalar". The
+  // lookup kernel is 256-bit and serves AVX-512 machines too.
+  static const char* utf8_kernel() noexcept;
+
+ private:
+  std::vector<std::uint32_t> newlines_;
+  std::vector<std::uint32_t> structurals_;
+  bool utf8_valid_ = true;
+};
+
+}  // namespace jsonl
@@ -0,0 +1,224 @@
+#include "transfer/chunk_manifest.h"
+
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+namespace jsonl {
+
+namespace {
+
+constexpr std::uint32_t kMagic = 0x4d434c4a;  // 'JLCM' on disk
+constexpr std::uint32_t kVersion = 1;
+
+struct Header {
+  std::uint32_t magic;
+  std::uint32_t version;
+  std::uint64_t min_bytes;
+  std::uint64_t avg_bytes;
+  std::uint64_t max_bytes;
+  std::uint64_t total_bytes;
+  std::uint32_t chunk_count;
+  std::uint32_t reserved;
+};
+static_assert(sizeof(Header) == 48);
+
+struct Entry {
+  std::uint64_t offset;
+  std::uint64_t length;
+  std::uint64_t lo;
+  std::uint64_t hi;
+};
+static_assert(sizeof(Entry) == 32);
+
+// Gear table: 256 pseudo-random words from a fixed splitmix64 seed, so
+// cut points are identical across builds and machines.
+constexpr std::array<std::uint64_t, 256> make_gear() {
+  std::array<std::uint64_t, 256> gear{};
+  std::uint64_t x = 0x3779b97f4a7c15f5ull;
+  for (std::uint64_t& v : gear) {
+    x += 0x9e3779b97f4a7c15ull;
+    std::uint64_t z = x;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    v = z ^ (z >> 31);
+  }
+  return gear;
+}
+constexpr std::array<std::uint64_t, 256> kGear = make_gear();
+
+// Judgment masks live in the high bits: the gear hash shifts left, so the
+// high bits mix the longest window of history.
+constexpr std::uint64_t high_mask(unsigned bits) noexcept {
+  return bits == 0 ? 0 : ~std::uint64_t{0} << (64 - bits);
+}
+
+}  // namespace
+
+std::vector<ChunkInfo> chunk_content(std::string_view bytes,
+                                     const CdcOptions& options) {
+  std::vector<ChunkInfo> chunks;
+  if (bytes.empty()) return chunks;
+
+  const std::size_t avg = std::bit_ceil(options.avg_bytes);
+  const std::size_t min =
+      options.min_bytes < avg ? options.min_bytes : avg / 2;
+  const std::size_t max =
+      options.max_bytes > avg ? options.max_bytes : avg * 2;
+  const unsigned avg_bits =
+      static_cast<unsigned>(std::countr_zero(avg));
+  const std::uint64_t mask_strict = high_mask(avg_bits + 2);
+  const std::uint64_t mask_loose = high_mask(avg_bits - 2);
+
+  const unsigned char* p =
+      reinterpret_cast<const unsigned char*>(bytes.data());
+  std::size_t start = 0;
+  while (start < bytes.size()) {
+    const std::size_t remaining = bytes.size() - start;
+    std::size_t cut = remaining;  // the tail is its own chunk
+    if (remaining > min) {
+      const std::size_t normal = remaining < avg ? remaining : avg;
+      const std::size_t limit = remaining < max ? remaining : max;
+      std::uint64_t hash = 0;
+      std::size_t i = min;
+      for (; i < normal; ++i) {
+        hash = (hash << 1) + kGear[p[start + i]];
+        if ((hash & mask_strict) == 0) break;
+      }
+      if (i >= normal) {
+        for (; i < limit; ++i) {
+          hash = (hash << 1) + kGear[p[start + i]];
+          if ((hash & mask_loose) == 0) break;
+        }
+      }
+      cut = i < limit ? i + 1 : limit;
+    }
+    ChunkInfo info;
+    info.offset = start;
+    info.length = cut;
+    info.hash = fingerprint128(bytes.substr(start, cut));
+    chunks.push_back(info);
+    start += cut;
+  }
+  return chunks;
+}
+
+ChunkManifest::ChunkManifest(const std::string& manifest_path) {
+  MappedReader map(manifest_path);
+  const std::string_view bytes = map.data();
+  if (bytes.size() < sizeof(Header)) {
+    throw std::runtime_error(manifest_path + ": not a chunk manifest");
+  }
+  Header h;
+  std::memcpy(&h, bytes.data(), sizeof(h));
+  const std::uint64_t expect =
+      sizeof(Header) + std::uint64_t{h.chunk_count} * sizeof(Entry);
+  if (h.magic != kMagic || h.version != kVersion || bytes.size() < expect) {
+    throw std::runtime_error(manifest_path + ": not a chunk manifest");
+  }
+  options_.min_bytes = h.min_bytes;
+  options_.avg_bytes = h.avg_bytes;
+  options_.max_bytes = h.max_bytes;
+  total_bytes_ = h.total_bytes;
+
+  chunks_.reserve(h.chunk_count);
+  present_.reserve(h.chunk_count);
+  const char* at = bytes.data() + sizeof(Header);
+  for (std::uint32_t i = 0; i < h.chunk_count; ++i, at += sizeof(Entry)) {
+    Entry e;
+    std::memcpy(&e, at, sizeof(e));
+    chunks_.push_back({e.offset, e.length, Fingerprint{e.lo, e.hi}});
+    present_.insert(chunks_.back().hash);
+  }
+}
+
+bool ChunkManifest::contains(const Fingerprint& hash) const noexcept {
+  return present_.find(hash) != present_.end();
+}
+
+bool ChunkManifest::matches(std::string_view bytes) const {
+  if (bytes.size() != total_bytes_) return false;
+  const std::vector<ChunkInfo> fresh = chunk_content(bytes, options_);
+  if (fresh.size() != chunks_.size()) return false;
+  for (std::size_t i = 0; i < fresh.size(); ++i) {
+    if (fresh[i].offset != chunks_[i].offset ||
+        fresh[i].length != chunks_[i].length ||
+        !(fresh[i].hash == chunks_[i].hash)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ChunkManifest::write(const std::string& manifest_path,
+                          const std::vector<ChunkInfo>& chunks,
+                          const CdcOptions& options) {
+  std::uint64_t total = 0;
+  for (const ChunkInfo& c : chunks) total += c.length;
+
+  std::FILE* f = std::fopen(manifest_path.c_str(), "wb");
+  if (f == nullptr) {
+    throw std::system_error(errno, std::generic_category(),
+                            "open " + manifest_path);
+  }
+  bool ok = true;
+  Header h{kMagic,
+           kVersion,
+           options.min_bytes,
+           options.avg_bytes,
+           options.max_bytes,
+           total,
+           static_cast<std::uint32_t>(chunks.size()),
+           0};
+  ok = ok && std::fwrite(&h, 1, sizeof(h), f) == sizeof(h);
+  for (const ChunkInfo& c : chunks) {
+    Entry e{c.offset, c.length, c.hash.lo, c.hash.hi};
+    ok = ok && std::fwrite(&e, 1, sizeof(e), f) == sizeof(e);
+  }
+  if (std::fclose(f) != 0 || !ok) {
+    throw std::system_error(EIO, std::generic_category(),
+                            "write " + manifest_path);
+  }
+}
+
+std::vector<ChunkInfo> ChunkManifestBuilder::build(
+    const std::string& jsonl_path, const std::string& manifest_path,
+    const CdcOptions& options) {
+  MappedReader reader(jsonl_path);
+  std::vector<ChunkInfo> chunks = chunk_content(reader.data(), options);
+  ChunkManifest::write(manifest_path, chunks, options);
+  return chunks;
+}
+
+TransferPlan plan_transfer(const std::vector<ChunkInfo>& source_chunks,
+                           const ChunkManifest& destination) {
+  TransferPlan plan;
+  for (std::uint32_t i = 0; i < source_chunks.size(); ++i) {
+    const ChunkInfo& c = source_chunks[i];
+    if (destination.contains(c.hash)) {
+      plan.reuse_bytes += c.length;
+    } else {
+      plan.send.push_back(i);
+      plan.send_bytes += c.length;
+    }
+  }
+  return plan;
+}
+
+TransferPlan plan_transfer(const ChunkManifest& source,
+                           const ChunkManifest& destination) {
+  const CdcOptions& a = source.options();
+  const CdcOptions& b = destination.options();
+  if (a.min_bytes != b.min_bytes || a.avg_bytes != b.avg_bytes ||
+      a.max_bytes != b.max_bytes) {
+    throw std::runtime_error(
+        "chunk manifests built with different CdcOptions");
+  }
+  return plan_transfer(source.chunks(), destination);
+}
+
+}  // namespace jsonl
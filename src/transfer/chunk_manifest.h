@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include "dedup/deduplicator.h"
+#include "io/mapped_reader.h"
+
+namespace jsonl {
+
+// Content-defined chunking and per-chunk hash manifests for cross-DC
+// snapshot sync (`<log>.manifest` sidecar).
+//
+// Fixed-offset chunking re-transfers everything after any insertion
+// shifts the bytes. Content-defined cut points (FastCDC-style gear
+// rolling hash) realign after edits, so a nightly snapshot that is
+// appends plus an occasional compaction shares almost every chunk with
+// yesterday's copy. The manifest records each chunk's offset, length and
+// 128-bit fingerprint (fingerprint128, the same mul-fold hash the dedup
+// stage uses); a sync tool ships only the chunks absent from the
+// destination's manifest and verifies each as it lands — no second full
+// read of either file.
+//
+// Both sides must chunk with the same CdcOptions for their cut points to
+// agree; the options are stored in the manifest and checked by
+// plan_transfer.
+
+struct CdcOptions {
+  // Chunk size bounds. avg_bytes is rounded up to a power of two; the
+  // cut-point judgment is stricter below it and looser above (FastCDC
+  // normalized chunking), which tightens the size distribution without
+  // hurting realignment.
+  std::size_t min_bytes = 256 << 10;
+  std::size_t avg_bytes = 1 << 20;
+  std::size_t max_bytes = 4 << 20;
+};
+
+struct ChunkInfo {
+  std::uint64_t offset = 0;
+  std::uint64_t length = 0;
+  Fingerprint hash;
+};
+
+// Splits `bytes` at content-defined cut points and fingerprints each
+// chunk. Chunks tile the input exactly; an empty input yields no chunks.
+std::vector<ChunkInfo> chunk_content(std::string_view bytes,
+                                     const CdcOptions& options = {});
+
+// Chunks to ship from source to destination, by index into the source
+// chunk list.
+struct TransferPlan {
+  std::vector<std::uint32_t> send;
+  std::uint64_t send_bytes = 0;
+  std::uint64_t reuse_bytes = 0;
+};
+
+class ChunkManifest {
+ public:
+  // Loads an existing manifest. Throws std::system_error on I/O failure
+  // and std::runtime_error if the file is not a valid manifest.
+  explicit ChunkManifest(const std::string& manifest_path);
+
+  const std::vector<ChunkInfo>& chunks() const noexcept { return chunks_; }
+  std::uint64_t total_bytes() const noexcept { return total_bytes_; }
+  const CdcOptions& options() const noexcept { return options_; }
+
+  bool contains(const Fingerprint& hash) const noexcept;
+
+  // Whether `bytes` chunks and hashes to exactly this manifest — the
+  // post-assembly integrity check on the receiving side.
+  bool matches(std::string_view bytes) const;
+
+  // Serializes a chunk list (write-tmp-and-rename is the caller's
+  // business; manifests are small).
+  static void write(const std::string& manifest_path,
+                    const std::vector<ChunkInfo>& chunks,
+                    const CdcOptions& options);
+
+ private:
+  struct FingerprintHash {
+    std::size_t operator()(const Fingerprint& f) const noexcept {
+      return static_cast<std::size_t>(f.lo ^ f.hi);
+    }
+  };
+
+  std::vector<ChunkInfo> chunks_;
+  std::unordered_set<Fingerprint, FingerprintHash> present_;
+  std::uint64_t total_bytes_ = 0;
+  CdcOptions options_;
+};
+
+class ChunkManifestBuilder {
+ public:
+  // Chunks `jsonl_path` in one pass and writes `manifest_path`
+  // (conventionally `<jsonl_path>.manifest`). Returns the chunk list.
+  static std::vector<ChunkInfo> build(const std::string& jsonl_path,
+                                      const std::string& manifest_path,
+                                      const CdcOptions& options = {});
+};
+
+// Diffs a freshly chunked source against the destination's manifest. The
+// caller is responsible for having chunked with the destination's options.
+TransferPlan plan_transfer(const std::vector<ChunkInfo>& source_chunks,
+                           const ChunkManifest& destination);
+
+// Same, between two manifests; throws std::runtime_error when they were
+// built with different CdcOptions (their cut points are not comparable).
+TransferPlan plan_transfer(const ChunkManifest& source,
+                           const ChunkManifest& destination);
+
+}  // namespace jsonl
@@ -0,0 +1,34 @@
+// jlschema — infer a log's schema and emit a typed accessor header.
+//
+// Usage:
+//   jlschema <log.jsonl> <StructName> [sample_records]   > schema.h
+
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+
+#include "io/mapped_reader.h"
+#include "parse/schema_inference.h"
+
+int main(int argc, char** argv) {
+  if (argc < 3 || argc > 4) {
+    std::fprintf(stderr,
+                 "usage: %s <log.jsonl> <StructName> [sample_records]\n",
+                 argv[0]);
+    return 2;
+  }
+  try {
+    const std::size_t samples =
+        argc == 4 ? static_cast<std::size_t>(std::strtoull(argv[3], nullptr, 10))
+                  : 65536;
+    jsonl::MappedReader reader(argv[1]);
+    const jsonl::Schema schema = jsonl::infer_schema(reader.data(), samples);
+    const std::string header =
+        jsonl::generate_accessor_header(schema, argv[2], argv[1]);
+    std::fwrite(header.data(), 1, header.size(), stdout);
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "jlschema: %s\n", e.what());
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,61 @@
+// jsonlc — extract hot fields from a JSONL log into a columnar sidecar.
+//
+// Usage:
+//   jsonlc <log.jsonl> <field:type>...        writes <log.jsonl>.jsonlc
+//   types: i64, f64, str
+//
+// Example (the production dashboard set):
+//   jsonlc requests.jsonl timestamp:str endpoint:str latency_ms:i64 status:i64
+
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <vector>
+
+#include "columnar/column_set.h"
+
+namespace {
+
+int usage(const char* argv0) {
+  std::fprintf(stderr, "usage: %s <log.jsonl> <field:type>...\n", argv0);
+  std::fprintf(stderr, "  types: i64, f64, str\n");
+  return 2;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 3) return usage(argv[0]);
+
+  std::vector<jsonl::ColumnSpec> specs;
+  for (int i = 2; i < argc; ++i) {
+    const char* colon = std::strrchr(argv[i], ':');
+    if (colon == nullptr) return usage(argv[0]);
+    std::string name(argv[i], colon - argv[i]);
+    std::string type(colon + 1);
+    jsonl::ColumnType t;
+    if (type == "i64") {
+      t = jsonl::ColumnType::kInt64;
+    } else if (type == "f64") {
+      t = jsonl::ColumnType::kFloat64;
+    } else if (type == "str") {
+      t = jsonl::ColumnType::kDict;
+    } else {
+      return usage(argv[0]);
+    }
+    specs.push_back({std::move(name), t});
+  }
+
+  const std::string in = argv[1];
+  const std::string out = in + ".jsonlc";
+  try {
+    std::uint64_t rows = jsonl::ColumnSetBuilder::convert(in, out, specs);
+    std::fprintf(stderr, "%s: %llu rows, %zu columns\n", out.c_str(),
+                 static_cast<unsigned long long>(rows), specs.size());
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "jsonlc: %s\n", e.what());
+    return 1;
+  }
+  return 0;
+}